@@ -23,85 +23,212 @@
 #ifndef LIBGAMBIT_ARRAY_H
 #define LIBGAMBIT_ARRAY_H
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+
 namespace Gambit {
 
-/// A basic bounds-checked array
+/// \brief A basic bounds-checked array
+///
+/// Elements are indexed from mindex to maxdex; for compatibility with
+/// existing code, the pointer data is offset so that data[mindex] is the
+/// first element.  Storage is allocated for a capacity which may exceed
+/// the length, and which grows geometrically, so that appending elements
+/// takes amortized constant time.  Elements beyond the length are not
+/// constructed.
 template <class T> class Array  {
 protected:
   int mindex, maxdex;
   T *data;
+  int m_capacity;
+
+  /// @name Private helpers for managing storage
+  //@{
+  /// Returns the first element of the storage
+  T *Storage() const { return (m_capacity > 0) ? data + mindex : nullptr; }
+  /// Allocates uninitialized storage for the given number of elements
+  static T *Allocate(int p_capacity)
+  {
+    return ((p_capacity > 0) ?
+	    static_cast<T *>(::operator new(p_capacity * sizeof(T))) : nullptr);
+  }
+  /// Destroys the elements, and frees the storage
+  void Deallocate()
+  {
+    T *storage = Storage();
+    for (int i = 0; i < Length(); i++) storage[i].~T();
+    ::operator delete(storage);
+    data = nullptr;
+    m_capacity = 0;
+  }
+  /// Allocates storage for the given number of elements, with the
+  /// bounds set from lo to hi, but no elements constructed
+  void Initialize(int lo, int hi, int p_capacity)
+  {
+    mindex = lo;  maxdex = hi;  m_capacity = p_capacity;
+    data = (p_capacity > 0) ? Allocate(p_capacity) - mindex : nullptr;
+  }
+  /// Ensures storage for at least the given number of elements,
+  /// at least doubling the capacity if it must grow
+  void Grow(int p_capacity)
+  {
+    if (p_capacity <= m_capacity)  return;
+    p_capacity = std::max(p_capacity, 2 * m_capacity);
+    T *storage = Allocate(p_capacity), *old = Storage();
+    for (int i = 0; i < Length(); i++) {
+      ::new (static_cast<void *>(storage + i)) T(std::move_if_noexcept(old[i]));
+      old[i].~T();
+    }
+    ::operator delete(old);
+    data = storage - mindex;
+    m_capacity = p_capacity;
+  }
+  //@}
 
   /// Private helper function that accomplishes the insertion of an object
   int InsertAt(const T &t, int n)
   {
     if (this->mindex > n || n > this->maxdex + 1)  throw IndexException();
 
-    T *new_data = new T[++this->maxdex - this->mindex + 1] - this->mindex;
-
-    int i;
-    for (i = this->mindex; i <= n - 1; i++) new_data[i] = this->data[i];
-    new_data[i++] = t;
-    for (; i <= this->maxdex; i++) new_data[i] = this->data[i - 1];
-
-    if (this->data)   delete [] (this->data + this->mindex);
-    this->data = new_data;
+    if (n == this->maxdex + 1) {
+      if (Length() < m_capacity) {
+	::new (static_cast<void *>(data + n)) T(t);
+      }
+      else {
+	// t may be an element of the array, so is copied before growing
+	T value(t);
+	Grow(Length() + 1);
+	::new (static_cast<void *>(data + n)) T(std::move(value));
+      }
+      this->maxdex++;
+      return n;
+    }
 
+    T value(t);
+    Grow(Length() + 1);
+    ::new (static_cast<void *>(data + this->maxdex + 1)) T(std::move(data[this->maxdex]));
+    for (int i = this->maxdex; i > n; i--)  data[i] = std::move(data[i - 1]);
+    data[n] = std::move(value);
+    this->maxdex++;
     return n;
   }
+
 public:
+  /// A random-access iterator over the elements of an array
   class iterator {
   private:
-    Array &m_array;
+    Array *m_array;
     int m_index;
   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() : m_array(nullptr), m_index(0) { }
     iterator(Array &p_array, int p_index)
-      : m_array(p_array), m_index(p_index)  { }
-    T &operator*()  { return m_array[m_index]; }
-    T &operator->()  { return m_array[m_index]; }
+      : m_array(&p_array), m_index(p_index)  { }
+    T &operator*() const  { return m_array->data[m_index]; }
+    /// As elements are typically handles to game objects, this returns
+    /// the element itself, so that it->f() calls f on the object
+    T &operator->() const  { return m_array->data[m_index]; }
+    T &operator[](difference_type n) const { return m_array->data[m_index + n]; }
     iterator &operator++()  { m_index++; return *this; }
+    iterator operator++(int)  { iterator it(*this); m_index++; return it; }
+    iterator &operator--()  { m_index--; return *this; }
+    iterator operator--(int)  { iterator it(*this); m_index--; return it; }
+    iterator &operator+=(difference_type n)  { m_index += n; return *this; }
+    iterator &operator-=(difference_type n)  { m_index -= n; return *this; }
+    iterator operator+(difference_type n) const  { return iterator(*m_array, m_index + n); }
+    iterator operator-(difference_type n) const  { return iterator(*m_array, m_index - n); }
+    friend iterator operator+(difference_type n, const iterator &it)  { return it + n; }
+    difference_type operator-(const iterator &it) const  { return m_index - it.m_index; }
     bool operator==(const iterator &it) const
-    { return (&m_array == &it.m_array) && (m_index == it.m_index); }
+    { return (m_array == it.m_array) && (m_index == it.m_index); }
     bool operator!=(const iterator &it) const
     { return !(*this == it); }
+    bool operator<(const iterator &it) const  { return m_index < it.m_index; }
+    bool operator>(const iterator &it) const  { return m_index > it.m_index; }
+    bool operator<=(const iterator &it) const  { return m_index <= it.m_index; }
+    bool operator>=(const iterator &it) const  { return m_index >= it.m_index; }
   };
 
+  /// A random-access iterator over the elements of a constant array
   class const_iterator {
   private:
-    const Array &m_array;
+    const Array *m_array;
     int m_index;
   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() : m_array(nullptr), m_index(0) { }
     const_iterator(const Array &p_array, int p_index)
-      : m_array(p_array), m_index(p_index)  { }
-    const T &operator*() const { return m_array[m_index]; }
-    const T &operator->() const { return m_array[m_index]; }
+      : m_array(&p_array), m_index(p_index)  { }
+    const T &operator*() const { return m_array->data[m_index]; }
+    /// As elements are typically handles to game objects, this returns
+    /// the element itself, so that it->f() calls f on the object
+    const T &operator->() const { return m_array->data[m_index]; }
+    const T &operator[](difference_type n) const { return m_array->data[m_index + n]; }
     const_iterator &operator++()  { m_index++; return *this; }
+    const_iterator operator++(int)  { const_iterator it(*this); m_index++; return it; }
+    const_iterator &operator--()  { m_index--; return *this; }
+    const_iterator operator--(int)  { const_iterator it(*this); m_index--; return it; }
+    const_iterator &operator+=(difference_type n)  { m_index += n; return *this; }
+    const_iterator &operator-=(difference_type n)  { m_index -= n; return *this; }
+    const_iterator operator+(difference_type n) const  { return const_iterator(*m_array, m_index + n); }
+    const_iterator operator-(difference_type n) const  { return const_iterator(*m_array, m_index - n); }
+    friend const_iterator operator+(difference_type n, const const_iterator &it)  { return it + n; }
+    difference_type operator-(const const_iterator &it) const  { return m_index - it.m_index; }
     bool operator==(const const_iterator &it) const
-    { return (&m_array == &it.m_array) && (m_index == it.m_index); }
+    { return (m_array == it.m_array) && (m_index == it.m_index); }
     bool operator!=(const const_iterator &it) const
     { return !(*this == it); }
+    bool operator<(const const_iterator &it) const  { return m_index < it.m_index; }
+    bool operator>(const const_iterator &it) const  { return m_index > it.m_index; }
+    bool operator<=(const const_iterator &it) const  { return m_index <= it.m_index; }
+    bool operator>=(const const_iterator &it) const  { return m_index >= it.m_index; }
   };
 
   /// @name Lifecycle
   //@{
   /// Constructs an array of length 'len', starting at '1'
   explicit Array(unsigned int len = 0)
-    : mindex(1), maxdex(len), data((len) ? new T[len] - 1 : 0) { } 
+  {
+    Initialize(1, len, len);
+    for (int i = mindex; i <= maxdex; i++)  ::new (static_cast<void *>(data + i)) T();
+  }
   /// Constructs an array starting at lo and ending at hi
-  Array(int lo, int hi) : mindex(lo), maxdex(hi)
+  Array(int lo, int hi)
   {
-    if (maxdex + 1 < mindex)   throw RangeException();
-    data = (maxdex >= mindex) ? new T[maxdex -mindex + 1] - mindex : 0;
+    if (hi + 1 < lo)   throw RangeException();
+    Initialize(lo, hi, hi - lo + 1);
+    for (int i = mindex; i <= maxdex; i++)  ::new (static_cast<void *>(data + i)) T();
   }
   /// Copy the contents of another array
   Array(const Array<T> &a)
-    : mindex(a.mindex), maxdex(a.maxdex),
-      data((maxdex >= mindex) ? new T[maxdex - mindex + 1] - mindex : 0)
   {
-    for (int i = mindex; i <= maxdex; i++)  data[i] = a.data[i];
+    Initialize(a.mindex, a.maxdex, a.Length());
+    for (int i = mindex; i <= maxdex; i++)  ::new (static_cast<void *>(data + i)) T(a.data[i]);
+  }
+  /// Move the contents of another array, leaving it empty
+  Array(Array<T> &&a) noexcept
+    : mindex(a.mindex), maxdex(a.maxdex), data(a.data), m_capacity(a.m_capacity)
+  {
+    a.data = nullptr;
+    a.maxdex = a.mindex - 1;
+    a.m_capacity = 0;
   }
   /// Destruct and deallocates the array
   virtual ~Array()
-  { if (maxdex >= mindex)  delete [] (data + mindex); }
+  { Deallocate(); }
 
   /// Copy the contents of another array
   Array<T> &operator=(const Array<T> &a)
@@ -112,17 +239,31 @@ public:
       // _essential_ for the correctness of the PVector and DVector
       // assignment operator, since it assumes the value of data does
       // not change.
-      if (!data || (data && (mindex != a.mindex || maxdex != a.maxdex)))  {
-	if (data)   delete [] (data + mindex);
-	mindex = a.mindex;   maxdex = a.maxdex;
-	data = (maxdex >= mindex) ? new T[maxdex - mindex + 1] - mindex : 0;
+      if (mindex == a.mindex && maxdex == a.maxdex) {
+	for (int i = mindex; i <= maxdex; i++) data[i] = a.data[i];
+      }
+      else {
+	Deallocate();
+	Initialize(a.mindex, a.maxdex, a.Length());
+	for (int i = mindex; i <= maxdex; i++)  ::new (static_cast<void *>(data + i)) T(a.data[i]);
       }
-      
-      for (int i = mindex; i <= maxdex; i++) data[i] = a.data[i];
     }
 
     return *this;
   }
+  /// Move the contents of another array, leaving it empty
+  Array<T> &operator=(Array<T> &&a) noexcept
+  {
+    if (this != &a) {
+      Deallocate();
+      mindex = a.mindex;  maxdex = a.maxdex;
+      data = a.data;  m_capacity = a.m_capacity;
+      a.data = nullptr;
+      a.maxdex = a.mindex - 1;
+      a.m_capacity = 0;
+    }
+    return *this;
+  }
 
   //@}
 
@@ -214,16 +355,9 @@ public:
   {
     if (n < this->mindex || n > this->maxdex) throw IndexException();
 
-    T ret(this->data[n]);
-    T *new_data = (--this->maxdex>=this->mindex) ? new T[this->maxdex-this->mindex+1] - this->mindex : 0;
-    
-    int i;
-    for (i = this->mindex; i < n; i++) new_data[i] = this->data[i];
-    for (; i <= this->maxdex; i++)     new_data[i] = this->data[i + 1];
-
-    delete [] (this->data + this->mindex);
-    this->data = new_data;
-
+    T ret(std::move(this->data[n]));
+    for (int i = n; i < this->maxdex; i++)  this->data[i] = std::move(this->data[i + 1]);
+    this->data[this->maxdex--].~T();
     return ret;
   }
   //@}
@@ -248,14 +382,49 @@ public:
   /// Access last element.
   T &back()              { return data[maxdex]; }
   
+  /// Returns the number of elements for which storage is allocated.
+  size_t capacity() const  { return m_capacity; }
+  /// Ensures storage is allocated for at least the given number of
+  /// elements, so that appending up to that many does not reallocate.
+  void reserve(size_t n)  { Grow(n); }
+
   /// Adds a new element at the end of the array container, after its
   /// current last element.
   void push_back(const T &val) { InsertAt(val, this->maxdex + 1); }
+  /// Adds a new element at the end of the array container, moving from
+  /// the value passed.
+  void push_back(T &&val)
+  {
+    if (Length() == m_capacity) {
+      T value(std::move(val));
+      Grow(Length() + 1);
+      ::new (static_cast<void *>(data + this->maxdex + 1)) T(std::move(value));
+    }
+    else {
+      ::new (static_cast<void *>(data + this->maxdex + 1)) T(std::move(val));
+    }
+    this->maxdex++;
+  }
+  /// Adds a new element at the end of the array container, constructed
+  /// in place from the arguments passed.
+  template <class... Args> T &emplace_back(Args &&... args)
+  {
+    if (Length() == m_capacity) {
+      T value(std::forward<Args>(args)...);
+      Grow(Length() + 1);
+      ::new (static_cast<void *>(data + this->maxdex + 1)) T(std::move(value));
+    }
+    else {
+      ::new (static_cast<void *>(data + this->maxdex + 1)) T(std::forward<Args>(args)...);
+    }
+    return data[++this->maxdex];
+  }
+  /// Removes the last element of the array container.
+  void pop_back()  { data[this->maxdex--].~T(); }
   /// Removes all elements from the array container (which are destroyed),
-  /// leaving the container with a size of 0.
+  /// leaving the container with a size of 0.  The storage is retained.
   void clear()  {
-    delete [] (this->data + this->mindex);
-    this->data = 0;
+    for (int i = this->mindex; i <= this->maxdex; i++)  this->data[i].~T();
     this->maxdex = this->mindex - 1;
   }
   ///@}
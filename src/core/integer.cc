@@ -322,7 +322,9 @@ IntegerRep* Icopy_ulong(IntegerRep* old, unsigned long x)
   while (x != 0)
   {
     src[srclen++] = extract(x);
-    x = down(x);
+    // Not down(x), which keeps only the next digit, and so would
+    // truncate a long of more than two digits
+    x >>= I_SHIFT;
   }
 
   IntegerRep* rep;
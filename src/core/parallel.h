@@ -0,0 +1,224 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/core/parallel.h
+// Running independent tasks on several threads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_PARALLEL_H
+#define LIBGAMBIT_PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Gambit {
+
+/// Returns the number of threads to use when none is specified
+inline int DefaultThreadCount()
+{
+  unsigned int count = std::thread::hardware_concurrency();
+  return (count > 0) ? static_cast<int>(count) : 1;
+}
+
+///
+/// Calls p_task(i) for each i = 1, ..., p_count, on up to p_threads
+/// threads (all available processors if p_threads <= 0).  The tasks
+/// share one counter from which each thread takes the next unstarted
+/// index whenever it finishes one, so tasks of uneven length keep all
+/// threads busy.  A task returns false to stop the loop early: tasks
+/// already running finish, but no new ones are started.  If a task throws,
+/// the loop stops in the same way, and the first exception is rethrown
+/// to the caller once all threads have finished.  With one thread, the
+/// tasks run in order on the calling thread.
+///
+template <class Task> void ParallelFor(int p_count, int p_threads, Task p_task)
+{
+  if (p_threads <= 0) {
+    p_threads = DefaultThreadCount();
+  }
+  if (p_threads > p_count) {
+    p_threads = p_count;
+  }
+  if (p_threads <= 1) {
+    for (int i = 1; i <= p_count && p_task(i); i++);
+    return;
+  }
+
+  std::atomic<int> next(1);
+  std::atomic<bool> stop(false);
+  std::exception_ptr error;
+  std::mutex errorLock;
+  auto worker = [&]() {
+    while (!stop.load(std::memory_order_relaxed)) {
+      int i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i > p_count) {
+        return;
+      }
+      try {
+        if (!p_task(i)) {
+          stop = true;
+        }
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(errorLock);
+        if (!error) {
+          error = std::current_exception();
+        }
+        stop = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < p_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+///
+/// Computes p_task(i) for each i = 1, ..., p_count on up to p_threads
+/// threads, as ParallelFor() does, and passes each result to
+/// p_emit(i, result) in order of i.  A result is emitted as soon as it
+/// and all those before it are available, so output can begin before
+/// all tasks have finished.  Calls to p_emit are never concurrent.
+///
+template <class Result, class Task, class Emit>
+void ParallelForOrdered(int p_count, int p_threads, Task p_task, Emit p_emit)
+{
+  std::vector<Result> results(p_count);
+  std::vector<char> ready(p_count, 0);
+  int next = 1;
+  std::mutex lock;
+  ParallelFor(p_count, p_threads, [&](int i) {
+    Result result = p_task(i);
+    std::lock_guard<std::mutex> guard(lock);
+    results[i - 1] = std::move(result);
+    ready[i - 1] = 1;
+    for (; next <= p_count && ready[next - 1]; next++) {
+      p_emit(next, results[next - 1]);
+      results[next - 1] = Result();
+    }
+    return true;
+  });
+}
+
+///
+/// Carries out a depth-first search on up to p_threads threads (all
+/// available processors if p_threads <= 0), starting from p_root.
+/// Calling p_task(item, children) processes one item, and appends to
+/// children the items to search from it, which are visited in the order
+/// appended.  Pending items are kept on one shared stack; an idle thread
+/// takes the most recently added one, so each thread works down a branch
+/// while the others pick up the siblings left behind.  With one thread,
+/// items are therefore processed in exactly the order of a recursive
+/// depth-first search.  A task returns false to stop the search, and
+/// exceptions are handled as in ParallelFor().
+///
+template <class Item, class Task>
+void ParallelDepthFirst(Item p_root, int p_threads, Task p_task)
+{
+  if (p_threads <= 0) {
+    p_threads = DefaultThreadCount();
+  }
+
+  std::vector<Item> stack;
+  stack.push_back(std::move(p_root));
+  if (p_threads == 1) {
+    std::vector<Item> children;
+    while (!stack.empty()) {
+      Item item = std::move(stack.back());
+      stack.pop_back();
+      children.clear();
+      if (!p_task(item, children)) {
+        return;
+      }
+      for (auto child = children.rbegin(); child != children.rend(); ++child) {
+        stack.push_back(std::move(*child));
+      }
+    }
+    return;
+  }
+
+  std::mutex lock;
+  std::condition_variable wakeup;
+  int busy = 0;
+  bool stop = false;
+  std::exception_ptr error;
+  auto worker = [&]() {
+    std::vector<Item> children;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+      wakeup.wait(guard, [&]() { return stop || !stack.empty() || busy == 0; });
+      if (stop || stack.empty()) {
+        return;
+      }
+      Item item = std::move(stack.back());
+      stack.pop_back();
+      busy++;
+      guard.unlock();
+      children.clear();
+      bool proceed = false;
+      try {
+        proceed = p_task(item, children);
+      }
+      catch (...) {
+        guard.lock();
+        if (!error) {
+          error = std::current_exception();
+        }
+        guard.unlock();
+      }
+      guard.lock();
+      busy--;
+      if (!proceed) {
+        stop = true;
+      }
+      for (auto child = children.rbegin(); child != children.rend(); ++child) {
+        stack.push_back(std::move(*child));
+      }
+      wakeup.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < p_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_PARALLEL_H
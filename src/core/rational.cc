@@ -32,13 +32,97 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 #include <cmath>
 #include <cfloat>
 #include <cctype>
+#include <climits>
 
 namespace Gambit {
 
 static const Integer Int_One(1);
 
+//------------------------------------------------------------------------
+//                 Arithmetic on the inline representation
+//------------------------------------------------------------------------
+
+//
+// Each of these returns false if the result does not fit in the inline
+// representation, in which case the caller falls back to Integers.
+// The operands are assumed to satisfy the invariants of the inline
+// representation (in particular, no numerator is LONG_MIN, so all
+// absolute values and negations are safe).
+//
+
+static long gcd_small(long a, long b)
+{
+  if (a < 0)  a = -a;
+  while (b != 0) {
+    long t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+static bool add_small(long xn, long xd, long yn, long yd, long &rn, long &rd)
+{
+  // Following Knuth, TAOCP vol. 2, section 4.5.1, dividing out the
+  // common factor of the denominators before multiplying
+  long g = gcd_small(xd, yd);
+  if (g == 1) {
+    long a, b;
+    if (__builtin_mul_overflow(xn, yd, &a) ||
+	__builtin_mul_overflow(yn, xd, &b) ||
+	__builtin_add_overflow(a, b, &rn) ||
+	__builtin_mul_overflow(xd, yd, &rd)) {
+      return false;
+    }
+  }
+  else {
+    long s = xd / g, a, b, t;
+    if (__builtin_mul_overflow(xn, yd / g, &a) ||
+	__builtin_mul_overflow(yn, s, &b) ||
+	__builtin_add_overflow(a, b, &t) || t == LONG_MIN) {
+      // gcd_small() cannot take LONG_MIN, whose negation overflows
+      return false;
+    }
+    if (t == 0) {
+      rn = 0;
+      rd = 1;
+      return true;
+    }
+    long g2 = gcd_small(t, g);
+    rn = t / g2;
+    if (__builtin_mul_overflow(s, yd / g2, &rd)) {
+      return false;
+    }
+  }
+  return rn != LONG_MIN;
+}
+
+static bool mul_small(long xn, long xd, long yn, long yd, long &rn, long &rd)
+{
+  if (xn == 0 || yn == 0) {
+    rn = 0;
+    rd = 1;
+    return true;
+  }
+  // Cross-cancel, so that the result is in lowest terms
+  long g1 = gcd_small(xn, yd), g2 = gcd_small(yn, xd);
+  if (__builtin_mul_overflow(xn / g1, yn / g2, &rn) ||
+      __builtin_mul_overflow(xd / g2, yd / g1, &rd)) {
+    return false;
+  }
+  return rn != LONG_MIN;
+}
+
+//------------------------------------------------------------------------
+//                      Rational: Representation
+//------------------------------------------------------------------------
+
 void Rational::normalize()
 {
+  if (m_isSmall) {
+    // The inline representation is always kept in lowest terms
+    return;
+  }
   int s = sign(den);
   if (s == 0)  {
     throw ZeroDivideException();
@@ -53,69 +137,128 @@ void Rational::normalize()
     num /= g;
     den /= g;
   }
+  demote();
 }
 
-void      add(const Rational& x, const Rational& y, Rational& r)
+/// Switches to the inline representation, if the value fits
+void Rational::demote()
 {
-  if (&r != &x && &r != &y)
-    {
-      mul(x.num, y.den, r.num);
-      mul(x.den, y.num, r.den);
-      add(r.num, r.den, r.num);
-      mul(x.den, y.den, r.den);
-    }
-  else
-    {
-      Integer tmp;
-      mul(x.den, y.num, tmp);
-      mul(x.num, y.den, r.num);
-      add(r.num, tmp, r.num);
-      mul(x.den, y.den, r.den);
+  if (!m_isSmall && num.fits_in_long() && den.fits_in_long()) {
+    long n = num.as_long();
+    if (n != LONG_MIN) {
+      setSmall(n, den.as_long());
     }
+  }
+}
+
+/// Returns the numerator as an Integer, using tmp to hold it if needed
+const Integer &Rational::bigNumerator(Integer &tmp) const
+{
+  if (!m_isSmall)  return num;
+  tmp = m_smallNum;
+  return tmp;
+}
+
+/// Returns the denominator as an Integer, using tmp to hold it if needed
+const Integer &Rational::bigDenominator(Integer &tmp) const
+{
+  if (!m_isSmall)  return den;
+  tmp = m_smallDen;
+  return tmp;
+}
+
+//------------------------------------------------------------------------
+//                      Rational: Arithmetic
+//------------------------------------------------------------------------
+
+void      add(const Rational& x, const Rational& y, Rational& r)
+{
+  long n, d;
+  if (x.m_isSmall && y.m_isSmall &&
+      add_small(x.m_smallNum, x.m_smallDen, y.m_smallNum, y.m_smallDen, n, d)) {
+    r.setSmall(n, d);
+    return;
+  }
+
+  Integer t1, t2, t3, t4, tmp, rnum, rden;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
+  const Integer &yn = y.bigNumerator(t3), &yd = y.bigDenominator(t4);
+  mul(xd, yn, tmp);
+  mul(xn, yd, rnum);
+  add(rnum, tmp, rnum);
+  mul(xd, yd, rden);
+  r.num = rnum;
+  r.den = rden;
+  r.m_isSmall = false;
   r.normalize();
 }
 
 void      sub(const Rational& x, const Rational& y, Rational& r)
 {
-  if (&r != &x && &r != &y)
-    {
-      mul(x.num, y.den, r.num);
-      mul(x.den, y.num, r.den);
-      sub(r.num, r.den, r.num);
-      mul(x.den, y.den, r.den);
-    }
-  else
-    {
-      Integer tmp;
-      mul(x.den, y.num, tmp);
-      mul(x.num, y.den, r.num);
-      sub(r.num, tmp, r.num);
-      mul(x.den, y.den, r.den);
-    }
+  long n, d;
+  if (x.m_isSmall && y.m_isSmall &&
+      add_small(x.m_smallNum, x.m_smallDen, -y.m_smallNum, y.m_smallDen, n, d)) {
+    r.setSmall(n, d);
+    return;
+  }
+
+  Integer t1, t2, t3, t4, tmp, rnum, rden;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
+  const Integer &yn = y.bigNumerator(t3), &yd = y.bigDenominator(t4);
+  mul(xd, yn, tmp);
+  mul(xn, yd, rnum);
+  sub(rnum, tmp, rnum);
+  mul(xd, yd, rden);
+  r.num = rnum;
+  r.den = rden;
+  r.m_isSmall = false;
   r.normalize();
 }
 
 void      mul(const Rational& x, const Rational& y, Rational& r)
 {
-  mul(x.num, y.num, r.num);
-  mul(x.den, y.den, r.den);
+  long n, d;
+  if (x.m_isSmall && y.m_isSmall &&
+      mul_small(x.m_smallNum, x.m_smallDen, y.m_smallNum, y.m_smallDen, n, d)) {
+    r.setSmall(n, d);
+    return;
+  }
+
+  Integer t1, t2, t3, t4, rnum, rden;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
+  const Integer &yn = y.bigNumerator(t3), &yd = y.bigDenominator(t4);
+  mul(xn, yn, rnum);
+  mul(xd, yd, rden);
+  r.num = rnum;
+  r.den = rden;
+  r.m_isSmall = false;
   r.normalize();
 }
 
 void      div(const Rational& x, const Rational& y, Rational& r)
 {
-  if (&r != &x && &r != &y)
-    {
-      mul(x.num, y.den, r.num);
-      mul(x.den, y.num, r.den);
+  long n, d;
+  if (x.m_isSmall && y.m_isSmall && y.m_smallNum != 0) {
+    // Multiply by the reciprocal of y, keeping its denominator positive
+    long yn = y.m_smallDen, yd = y.m_smallNum;
+    if (yd < 0) {
+      yn = -yn;
+      yd = -yd;
     }
-  else
-    {
-      Integer tmp;
-      mul(x.num, y.den, tmp);
-      mul(y.num, x.den, r.den);
-      r.num = tmp;
+    if (mul_small(x.m_smallNum, x.m_smallDen, yn, yd, n, d)) {
+      r.setSmall(n, d);
+      return;
     }
+  }
+
+  Integer t1, t2, t3, t4, rnum, rden;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
+  const Integer &yn = y.bigNumerator(t3), &yd = y.bigDenominator(t4);
+  mul(xn, yd, rnum);
+  mul(xd, yn, rden);
+  r.num = rnum;
+  r.den = rden;
+  r.m_isSmall = false;
   r.normalize();
 }
 
@@ -124,6 +267,19 @@ void      div(const Rational& x, const Rational& y, Rational& r)
 
 void Rational::invert()
 {
+  if (m_isSmall) {
+    if (m_smallNum == 0) {
+      throw ZeroDivideException();
+    }
+    else if (m_smallNum < 0) {
+      setSmall(-m_smallDen, -m_smallNum);
+    }
+    else {
+      setSmall(m_smallDen, m_smallNum);
+    }
+    return;
+  }
+
   Integer tmp = num;  
   num = den;  
   den = tmp;  
@@ -139,14 +295,30 @@ void Rational::invert()
 
 int compare(const Rational& x, const Rational& y)
 {
-  int xsgn = sign(x.num);
-  int ysgn = sign(y.num);
+  int xsgn = sign(x);
+  int ysgn = sign(y);
   int d = xsgn - ysgn;
-  if (d == 0 && xsgn != 0) d = compare(x.num * y.den, x.den * y.num);
-  return d;
+  if (d != 0 || xsgn == 0)  return d;
+
+  if (x.m_isSmall && y.m_isSmall) {
+    if (x.m_smallDen == y.m_smallDen) {
+      return (x.m_smallNum > y.m_smallNum) - (x.m_smallNum < y.m_smallNum);
+    }
+    long a, b;
+    if (!__builtin_mul_overflow(x.m_smallNum, y.m_smallDen, &a) &&
+	!__builtin_mul_overflow(x.m_smallDen, y.m_smallNum, &b)) {
+      return (a > b) - (a < b);
+    }
+  }
+
+  Integer t1, t2, t3, t4;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
+  const Integer &yn = y.bigNumerator(t3), &yd = y.bigDenominator(t4);
+  return compare(xn * yd, xd * yn);
 }
 
 Rational::Rational(double x)
+  : m_isSmall(false), m_smallNum(0), m_smallDen(1)
 {
   num = 0;
   den = 1;
@@ -186,6 +358,7 @@ Rational::Rational(double x)
 
 Integer trunc(const Rational& x)
 {
+  if (x.m_isSmall)  return Integer(x.m_smallNum / x.m_smallDen);
   return x.num / x.den ;
 }
 
@@ -204,7 +377,7 @@ Rational Rational::operator-() const
 Rational abs(const Rational& x) 
 {
   Rational r(x);
-  if (sign(r.num) < 0) r.negate();
+  if (sign(r) < 0) r.negate();
   return r;
 }
 
@@ -212,14 +385,31 @@ Rational abs(const Rational& x)
 Rational sqr(const Rational& x)
 {
   Rational r;
-  mul(x.num, x.num, r.num);
-  mul(x.den, x.den, r.den);
+  long n, d;
+  if (x.m_isSmall &&
+      !__builtin_mul_overflow(x.m_smallNum, x.m_smallNum, &n) &&
+      !__builtin_mul_overflow(x.m_smallDen, x.m_smallDen, &d)) {
+    r.setSmall(n, d);
+    return r;
+  }
+
+  Integer t1, t2;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
+  mul(xn, xn, r.num);
+  mul(xd, xd, r.den);
+  r.m_isSmall = false;
   r.normalize();
   return r;
 }
 
 Integer floor(const Rational& x)
 {
+  if (x.m_isSmall) {
+    long q = x.m_smallNum / x.m_smallDen;
+    if (x.m_smallNum < 0 && x.m_smallNum % x.m_smallDen != 0) --q;
+    return Integer(q);
+  }
+
   Integer q;
   Integer r;
   divide(x.num, x.den, q, r);
@@ -229,6 +419,12 @@ Integer floor(const Rational& x)
 
 Integer ceil(const Rational& x)
 {
+  if (x.m_isSmall) {
+    long q = x.m_smallNum / x.m_smallDen;
+    if (x.m_smallNum >= 0 && x.m_smallNum % x.m_smallDen != 0) ++q;
+    return Integer(q);
+  }
+
   Integer q;
   Integer  r;
   divide(x.num, x.den, q, r);
@@ -238,6 +434,19 @@ Integer ceil(const Rational& x)
 
 Integer round(const Rational& x) 
 {
+  if (x.m_isSmall) {
+    long q = x.m_smallNum / x.m_smallDen;
+    long r = x.m_smallNum % x.m_smallDen;
+    // Twice the remainder can overflow a long, but not an unsigned long
+    if (2 * (unsigned long) ((r < 0) ? -r : r) >= (unsigned long) x.m_smallDen) {
+      if (x.m_smallNum >= 0)
+	++q;
+      else
+	--q;
+    }
+    return Integer(q);
+  }
+
   Integer q;
   Integer r;
   divide(x.num, x.den, q, r);
@@ -254,35 +463,43 @@ Integer round(const Rational& x)
 
 Rational pow(const Rational& x, long y)
 {
+  Integer t1, t2;
+  const Integer &xn = x.bigNumerator(t1), &xd = x.bigDenominator(t2);
   Rational r;
+  r.m_isSmall = false;
   if (y >= 0)
     {
-      pow(x.num, y, r.num);
-      pow(x.den, y, r.den);
+      pow(xn, y, r.num);
+      pow(xd, y, r.den);
     }
   else
     {
       y = -y;
-      pow(x.num, y, r.den);
-      pow(x.den, y, r.num);
+      pow(xn, y, r.den);
+      pow(xd, y, r.num);
       if (sign(r.den) < 0)
 	{
 	  r.num.negate();
 	  r.den.negate();
 	}
     }
+  r.demote();
   return r;
 }
 
 std::ostream &operator << (std::ostream &s, const Rational& y)
 {
-  if (y.denominator() == 1L)
-    s << y.numerator();
+  if (y.m_isSmall) {
+    s << y.m_smallNum;
+    if (y.m_smallDen != 1)  s << "/" << y.m_smallDen;
+  }
+  else if (y.den == 1L)
+    s << y.num;
   else
     {
-      s << y.numerator();
+      s << y.num;
       s << "/";
-      s << y.denominator();
+      s << y.den;
     }
   return s;
 }
@@ -356,17 +573,21 @@ std::istream &operator>>(std::istream &f, Rational &y)
   }
 
   y = Rational(num * sign, denom);
-  y.normalize();
-
   return f;
 }
 
 bool Rational::OK() const
 {
+  if (m_isSmall) {
+    return m_smallDen > 0 && m_smallNum != LONG_MIN &&
+      gcd_small(m_smallNum, m_smallDen) == 1;
+  }
   int v = num.OK() && den.OK(); // have valid num and denom
   if (v)   {
     v &= sign(den) > 0;           // denominator positive;
     v &=  ucompare(gcd(num, den), Int_One) == 0; // relatively prime
+    v &= !(num.fits_in_long() && den.fits_in_long() &&
+	   num.as_long() != LONG_MIN);  // too large to be held inline
   }
   // if (!v) error("invariant failure");
   return v;
@@ -389,18 +610,26 @@ Rational::fits_in_double() const
 // These were moved from the header file to eliminate warnings
 //
 
-static IntegerRep ZeroRep = {1, 0, 1, {0}};
-static IntegerRep OneRep = {1, 0, 1, {1}};
-
-Rational::Rational() : num(&ZeroRep), den(&OneRep) {}
+Rational::Rational() : m_isSmall(true), m_smallNum(0), m_smallDen(1) {}
 Rational::~Rational() = default;
 
-Rational::Rational(const Rational& y)  = default;
+Rational::Rational(const Rational& y)
+  : m_isSmall(y.m_isSmall), m_smallNum(y.m_smallNum), m_smallDen(y.m_smallDen)
+{
+  if (!m_isSmall) {
+    num = y.num;
+    den = y.den;
+  }
+}
 
-Rational::Rational(const Integer& n) :num(n), den(&OneRep) {}
+Rational::Rational(const Integer& n)
+  : m_isSmall(false), m_smallNum(0), m_smallDen(1), num(n), den(1)
+{
+  demote();
+}
 
 Rational::Rational(const Integer& n, const Integer& d) 
- : num(n), den(d)
+  : m_isSmall(false), m_smallNum(0), m_smallDen(1), num(n), den(d)
 {
   if (d == 0)  {
     throw ZeroDivideException();
@@ -408,39 +637,68 @@ Rational::Rational(const Integer& n, const Integer& d)
   normalize();
 }
 
-Rational::Rational(long n) :num(n), den(&OneRep) { }
+Rational::Rational(long n)
+  : m_isSmall(n != LONG_MIN), m_smallNum(n), m_smallDen(1)
+{
+  if (!m_isSmall) {
+    num = n;
+    den = 1;
+  }
+}
 
-Rational::Rational(int n) :num(n), den(&OneRep) { }
+Rational::Rational(int n) : m_isSmall(true), m_smallNum(n), m_smallDen(1) { }
 
 Rational::Rational(long n, long d) 
- : num(n), den(d)
+  : m_isSmall(false), m_smallNum(0), m_smallDen(1)
 {
   if (d == 0) {
     throw ZeroDivideException();
   }
-  normalize();
+  if (n != LONG_MIN && d != LONG_MIN) {
+    if (d < 0) {
+      n = -n;
+      d = -d;
+    }
+    long g = gcd_small(n, d);
+    setSmall(n / g, d / g);
+  }
+  else {
+    num = n;
+    den = d;
+    normalize();
+  }
 }
 
 Rational::Rational(int n, int d) 
- : num(n), den(d) 
-{ 
-  if (d == 0) {
-    throw ZeroDivideException();
-  }
-  normalize(); 
-}
+  : Rational((long) n, (long) d)
+{ }
 
 Rational &Rational::operator =  (const Rational& y)
-= default;
+{
+  m_isSmall = y.m_isSmall;
+  m_smallNum = y.m_smallNum;
+  m_smallDen = y.m_smallDen;
+  if (!m_isSmall) {
+    num = y.num;
+    den = y.den;
+  }
+  return *this;
+}
 
 bool Rational::operator==(const Rational &y) const
 {
+  // Values are held inline whenever they fit, so a value held inline
+  // is never equal to one which is not
+  if (m_isSmall || y.m_isSmall) {
+    return (m_isSmall && y.m_isSmall &&
+	    m_smallNum == y.m_smallNum && m_smallDen == y.m_smallDen);
+  }
   return compare(num, y.num) == 0 && compare(den, y.den) == 0;
 }
 
 bool Rational::operator!=(const Rational &y) const
 {
-  return compare(num, y.num) != 0 || compare(den, y.den) != 0;
+  return !(*this == y);
 }
 
 bool Rational::operator< (const Rational &y) const
@@ -465,12 +723,16 @@ bool Rational::operator>=(const Rational &y) const
 
 int sign(const Rational& x)
 {
+  if (x.m_isSmall)  return (x.m_smallNum > 0) - (x.m_smallNum < 0);
   return sign(x.num);
 }
 
 void Rational::negate()
 {
-  num.negate();
+  if (m_isSmall)
+    m_smallNum = -m_smallNum;
+  else
+    num.negate();
 }
 
 
@@ -498,15 +760,31 @@ Rational &Rational::operator/=(const Rational& y)
   return *this;
 }
 
-const Integer& Rational::numerator() const { return num; }
-const Integer& Rational::denominator() const { return den; }
+Integer Rational::numerator() const
+{ return (m_isSmall) ? Integer(m_smallNum) : num; }
+Integer Rational::denominator() const
+{ return (m_isSmall) ? Integer(m_smallDen) : den; }
 
 Rational::operator double() const 
 {
+  if (m_isSmall) {
+    // This computes the same quotient as ratio() below, whose steps are
+    // exact while both terms fit in the mantissa of a double
+    const long mantissa = 1L << DBL_MANT_DIG;
+    long x = (m_smallNum < 0) ? -m_smallNum : m_smallNum;
+    if (x <= mantissa && m_smallDen <= mantissa) {
+      double d = (double) (x / m_smallDen);
+      long r = x % m_smallDen;
+      if (r != 0)  d += (double) r / (double) m_smallDen;
+      return sign(*this) * d;
+    }
+  }
+
   // We approach this in terms of absolute values because there is
   // (apparently) a bug in ratio() which yields incorrect results
   // for some negative numbers (TLT, 27 Feb 2006).
-  Integer x(num), y(den);
+  Integer t1, t2;
+  Integer x(bigNumerator(t1)), y(bigDenominator(t2));
   x.abs();
   y.abs();
   
@@ -534,9 +812,57 @@ Rational Rational::operator/(const Rational &y) const
 }
 
 
+//
+// Parses the common forms "n", "n/d" and "n.f", where the terms fit in
+// a long, without any Integer arithmetic.  Returns false if the text is
+// not of one of these forms, or does not fit.
+//
+static bool parse_small(const std::string &f, Rational &r)
+{
+  const char *p = f.c_str();
+  while (isspace(*p))  p++;
+  bool neg = (*p == '-');
+  if (neg)  p++;
+  if (!isdigit(*p) && *p != '.')  return false;
+
+  long num = 0, den = 1;
+  for (; isdigit(*p); p++) {
+    if (__builtin_mul_overflow(num, 10L, &num) ||
+	__builtin_add_overflow(num, (long) (*p - '0'), &num)) {
+      return false;
+    }
+  }
+  if (*p == '/') {
+    if (!isdigit(*++p))  return false;
+    den = 0;
+    for (; isdigit(*p); p++) {
+      if (__builtin_mul_overflow(den, 10L, &den) ||
+	  __builtin_add_overflow(den, (long) (*p - '0'), &den)) {
+	return false;
+      }
+    }
+  }
+  else if (*p == '.') {
+    for (p++; isdigit(*p); p++) {
+      if (__builtin_mul_overflow(den, 10L, &den) ||
+	  __builtin_mul_overflow(num, 10L, &num) ||
+	  __builtin_add_overflow(num, (long) (*p - '0'), &num)) {
+	return false;
+      }
+    }
+  }
+  if (*p != '\0')  return false;
+
+  r = Rational((neg) ? -num : num, den);
+  return true;
+}
+
 template<>
 Rational lexical_cast(const std::string &f)
 {
+  Rational r;
+  if (parse_small(f, r))  return r;
+
   char ch = ' ';
   int sign = 1;
   unsigned int index = 0, length = f.length();
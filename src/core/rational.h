@@ -33,12 +33,30 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 
 namespace Gambit {
 
-/// A representation of an arbitrary-precision rational number
+/// A representation of an arbitrary-precision rational number.
+///
+/// Values whose numerator and denominator both fit in a long are held
+/// inline, and arithmetic on them is done in machine integers.  Each
+/// such operation checks for overflow; if it occurs, the operation is
+/// redone with Integers.  Results are always held inline when they fit,
+/// so that the Integer representation is only used for large values.
 class Rational {
 protected:
+  /// True if the value is held in m_smallNum and m_smallDen, rather
+  /// than in num and den
+  bool m_isSmall;
+  /// The inline representation.  The denominator is positive, the
+  /// numerator is never LONG_MIN, and the two are relatively prime.
+  long m_smallNum, m_smallDen;
+  /// The Integer representation, used only for large values
   Integer num, den;
 
   void normalize();
+  void demote();
+  void setSmall(long n, long d)
+  { m_isSmall = true;  m_smallNum = n;  m_smallDen = d; }
+  const Integer &bigNumerator(Integer &tmp) const;
+  const Integer &bigDenominator(Integer &tmp) const;
 
 public:
   Rational();
@@ -85,8 +103,12 @@ public:
   friend Rational  sqr(const Rational& x);              // square
   friend Rational  pow(const Rational& x, long y);
   friend Rational  pow(const Rational& x, const Integer& y);
-  const Integer&   numerator() const;
-  const Integer&   denominator() const;
+  Integer          numerator() const;
+  Integer          denominator() const;
+  /// Sets n and d to the numerator and denominator, and returns true,
+  /// if both fit in a long
+  bool             as_long_ratio(long &n, long &d) const
+  { n = m_smallNum;  d = m_smallDen;  return m_isSmall; }
 
   // coercion & conversion
 
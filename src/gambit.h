@@ -128,6 +128,7 @@ public:
 
 #include "games/game.h"
 #include "games/writer.h"
+#include "games/binfile.h"
 
 #include "games/behavspt.h"
 #include "games/behav.h"
@@ -27,6 +27,7 @@
 #include <sstream>
 #include <cassert>
 #include <algorithm>
+#include "gambit.h"
 #include "games/agg/gray.h"
 #include "games/agg/agg.h"
 
@@ -45,7 +46,6 @@ AGG::AGG(int numPlayers, std::vector<int> &_actions, int numANodes, int _numPNod
  vector<vector<vector<config> > >& proj,
  vector<vector<proj_func*> > & projF,
  vector<vector<vector<int> > >& Po,
- vector<aggdistrib> &P,
  vector<aggpayoff>& _payoffs) :
 numPlayers(numPlayers),
 numActionNodes(numANodes),
@@ -55,14 +55,11 @@ neighbors(neighb),
 projectionTypes(projTypes),
 payoffs(_payoffs),
 projection(proj),
-projectedStrat(projS),
 fullProjectedStrat(projS),
 projFunctions(projF),
 Porder(Po),
-Pr(P),
 isPure(numANodes,true),
 node2Action(numANodes,vector<int>(numPlayers)),
-cache(numPlayers+1),
 player2Class(numPlayers),
 kSymStrategyOffset(1,0)
 {
@@ -135,6 +132,20 @@ kSymStrategyOffset(1,0)
 
 }
 
+AGG::~AGG()
+{
+  delete [] strategyOffset;
+  //free projFunctions
+  /*
+  for (size_t i=0; i<projFunctions.size(); ++i)
+      for (size_t j=0;j<projFunctions[i].size(); ++j)
+	  delete projFunctions[i][j];
+  */
+  for (size_t i=0;i<projectionTypes.size();++i){
+    delete projectionTypes[i];
+  }
+}
+
 /*
 AGG::AGG(const agg& other, bool completeGraph)
 :
@@ -390,7 +401,7 @@ AGG *AGG::makeAGG(istream &in){
       
     }
     AGG *r=nullptr;
-    r=new AGG(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    r=new AGG(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     if (!r)cout<<"Failed to allocate memory for new AGG";
     return r;
   } else {
@@ -460,7 +471,7 @@ vector<projtype>& projTypes, int seed, bool int_payoffs, int int_factor){
 	    numPayoffs += pays[i].size();
     }
     cout << "Creating an AGG with "<<numPayoffs <<" payoff values"<<endl;
-    AGG *r= new AGG(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    AGG *r= new AGG(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     
     return r;
  
@@ -580,10 +591,35 @@ AGG::initPorder(vector<int>& Po,
 
 
 
+void AGG::initWorkspace(Workspace &ws) const
+{
+  if ((int) ws.Pr.size() < numPlayers) {
+    ws.Pr.resize(numPlayers);
+  }
+  if ((int) ws.projectedStrat.size() < numActionNodes) {
+    ws.projectedStrat.resize(numActionNodes);
+  }
+  for (int Node = 0; Node < numActionNodes; Node++) {
+    if ((int) ws.projectedStrat[Node].size() < numPlayers) {
+      ws.projectedStrat[Node].resize(numPlayers);
+    }
+  }
+}
+
+//The workspace is shared by all games evaluated on the thread, and so
+//is only grown, never shrunk, to fit each.
+AGG::Workspace &AGG::getWorkspace() const
+{
+  static thread_local Workspace ws;
+  initWorkspace(ws);
+  return ws;
+}
+
 //compute the induced distribution 
 void
-AGG::computeP(int player, int act, int player2,int act2)
+AGG::computeP(Workspace &ws, int player, int act, int player2,int act2)
 {
+  std::vector<aggdistrib> &Pr = ws.Pr;
   //apply player's strat
   Pr[0].reset();
   Pr[0].insert(make_pair(projection[actionSets[player][act]][player][act], 1.0) );
@@ -604,25 +640,25 @@ AGG::computeP(int player, int act, int player2,int act2)
       }
     } else {
       Pr[k].multiply (Pr[k-1], 
-	projectedStrat[actionSets[player][act]][Porder[player][act][k]],
+	ws.projectedStrat[actionSets[player][act]][Porder[player][act][k]],
 	numNei  ,projFunctions[actionSets[player][act]] ); 
     }
   }
     
 }
 
-void AGG:: doProjection(int Node, AggNumber* s)
+void AGG:: doProjection(Workspace &ws, int Node, AggNumber* s)
 {
   for (int i=0;i<numPlayers;i++){
-    doProjection(Node,i, &(s[firstAction(i)]));
+    doProjection(ws, Node,i, &(s[firstAction(i)]));
   }
 }
 
-void AGG:: doProjection(int Node, int i, AggNumber* s)
+void AGG:: doProjection(Workspace &ws, int Node, int i, AggNumber* s)
 {
-  projectedStrat[Node][i].reset();
+  ws.projectedStrat[Node][i].reset();
   for (int j=0;j<actions[i];j++)if(s[j]>(AggNumber)0.0){
-    projectedStrat[Node][i]+= make_pair(projection[Node][i][j],
+    ws.projectedStrat[Node][i]+= make_pair(projection[Node][i][j],
               s[j]);
   }
 }
@@ -667,19 +703,246 @@ void AGG::getPayoffVector(AggNumberVector &dest, int player,const StrategyProfil
 }
 
 AggNumber AGG::getV(int player, int act,const StrategyProfile &s){
+    Workspace &ws = getWorkspace();
     //project s to the projectedStrat
-    doProjection(actionSets.at(player).at(act), s);
-    computeP(player, act);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
+    doProjection(ws, actionSets.at(player).at(act), s);
+    computeP(ws, player, act);
+    return ws.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
 }
 
 AggNumber AGG::getJ(int player1, int act1, int player2,int act2,StrategyProfile &s)
 {
-    doProjection(actionSets[player1][act1],s);
-    computeP(player1,act1,player2,act2);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+    Workspace &ws = getWorkspace();
+    doProjection(ws, actionSets[player1][act1],s);
+    computeP(ws, player1,act1,player2,act2);
+    return ws.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+}
+
+template <class T>
+void AGG::buildPayoffTables(std::vector<flat_distrib<T> > &tables) const
+{
+  tables.resize(numActionNodes);
+  for (int node = 0; node < numActionNodes; node++) {
+    tables[node].reset(neighbors[node].size());
+    for (auto p = payoffs[node].begin(); p != payoffs[node].end(); ++p) {
+      tables[node].add(p->first, (T) p->second);
+    }
+  }
 }
 
+template <>
+const flat_distrib<AggNumber> &AGG::getPayoffTable<AggNumber>(int Node)
+{
+  std::call_once(flatPayoffsBuilt, [this]() { buildPayoffTables(flatPayoffs); });
+  return flatPayoffs[Node];
+}
+
+template <>
+const flat_distrib<Rational> &AGG::getPayoffTable<Rational>(int Node)
+{
+  std::call_once(rationalPayoffsBuilt, [this]() { buildPayoffTables(rationalPayoffs); });
+  return rationalPayoffs[Node];
+}
+
+template <class T>
+void AGG::projectStrategy(flat_distrib<T> &dest, int Node, int i,
+                          const std::vector<T> &s) const
+{
+  dest.reset(neighbors[Node].size());
+  for (int j = 0; j < actions[i]; j++) {
+    if (s[firstAction(i) + j] > (T) 0) {
+      dest.add(projection[Node][i][j], s[firstAction(i) + j]);
+    }
+  }
+}
+
+//as computeP(player, act), but on distributions local to the thread.
+//The result is valid until the next call on the same thread.
+template <class T>
+const flat_distrib<T> &AGG::computeDistribution(int player, int act,
+                                                const std::vector<T> &s)
+{
+  static thread_local flat_distrib<T> dist[2];
+  static thread_local flat_distrib<T> strat;
+  int Node = actionSets[player][act];
+  dist[0].reset(neighbors[Node].size());
+  dist[0].add(projection[Node][player][act], (T) 1);
+  for (int k = 1; k < numPlayers; k++) {
+    projectStrategy(strat, Node, Porder[player][act][k], s);
+    dist[k % 2].multiply(dist[(k - 1) % 2], strat, projFunctions[Node]);
+  }
+  return dist[(numPlayers - 1) % 2];
+}
+
+template <class T>
+T AGG::computeMixedPayoff(int player, const std::vector<T> &s)
+{
+  assert(player >= 0 && player < numPlayers);
+  T result = (T) 0;
+  for (int act = 0; act < actions[player]; ++act) {
+    if (s[act + firstAction(player)] > (T) 0) {
+      result += s[act + firstAction(player)] *
+        computeDistribution(player, act, s).inner_prod(getPayoffTable<T>(actionSets[player][act]));
+    }
+  }
+  return result;
+}
+
+template <class T>
+void AGG::computePayoffVector(std::vector<T> &dest, int player,
+                              const std::vector<T> &s)
+{
+  assert(player >= 0 && player < numPlayers);
+  for (int act = 0; act < actions[player]; ++act) {
+    dest[act] = computeDistribution(player, act, s).inner_prod(getPayoffTable<T>(actionSets[player][act]));
+  }
+}
+
+//true if players p and q contribute in the same way to the configuration
+//at Node under s, so that either may stand for the other in a distribution
+template <class T>
+bool AGG::isInterchangeable(int Node, int p, int q, const std::vector<T> &s) const
+{
+  if (actions[p] != actions[q]) {
+    return false;
+  }
+  for (int j = 0; j < actions[p]; j++) {
+    if (s[firstAction(p) + j] != s[firstAction(q) + j] ||
+        projection[Node][p][j] != projection[Node][q][j]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//Sets the entries of row for the actions of the players in groups[g],
+//for g in [lo, hi), given the product outside of the distribution of the
+//player's own action and of the projected strategies of the players
+//outside the range.  Each group holds positions in Porder of players
+//that are interchangeable at the node.  The range is halved at each step,
+//and each half is passed the product of outside with the strategies of
+//the other half, so that distributions are only ever multiplied by a
+//single projected strategy.  A group is reached with the distribution
+//induced by all players but one of its members; the entries of that
+//member are computed, and copied to the others.
+template <class T>
+void AGG::computeJacobianRow(std::vector<T> &row, int player, int act,
+                             const flat_distrib<T> &outside,
+                             const std::vector<flat_distrib<T> > &strats,
+                             const std::vector<std::vector<int> > &groups,
+                             std::vector<flat_distrib<T> > &products,
+                             int lo, int hi, int depth)
+{
+  int Node = actionSets[player][act];
+  //multiplies outside by the strategies at the positions in the groups
+  //[first, last), leaving out the first member of the group skip.  Each
+  //level of the recursion has its own pair of products in products.
+  auto multiply = [&](int first, int last, int skip) -> const flat_distrib<T> & {
+    const flat_distrib<T> *current = &outside;
+    int count = 0;
+    for (int g = first; g < last; g++) {
+      for (size_t i = (g == skip) ? 1 : 0; i < groups[g].size(); i++) {
+        flat_distrib<T> &product = products[2 * depth + count++ % 2];
+        product.multiply(*current, strats[groups[g][i]], projFunctions[Node]);
+        current = &product;
+      }
+    }
+    return *current;
+  };
+
+  if (hi - lo == 1) {
+    const std::vector<int> &group = groups[lo];
+    const flat_distrib<T> &others = multiply(lo, hi, lo);
+    int player2 = Porder[player][act][group[0]];
+    for (int act2 = 0; act2 < actions[player2]; ++act2) {
+      row[firstAction(player2) + act2] =
+        others.inner_prod(projection[Node][player2][act2],
+                          projFunctions[Node], getPayoffTable<T>(Node));
+    }
+    for (size_t i = 1; i < group.size(); i++) {
+      std::copy(row.begin() + firstAction(player2),
+                row.begin() + firstAction(player2) + actions[player2],
+                row.begin() + firstAction(Porder[player][act][group[i]]));
+    }
+    return;
+  }
+  int mid = (lo + hi) / 2;
+  computeJacobianRow(row, player, act, multiply(mid, hi, -1), strats, groups,
+                     products, lo, mid, depth + 1);
+  computeJacobianRow(row, player, act, multiply(lo, mid, -1), strats, groups,
+                     products, mid, hi, depth + 1);
+}
+
+template <class T>
+void AGG::computePayoffJacobian(std::vector<T> &dest,
+                                std::vector<std::vector<T> > &jacobian,
+                                int player, const std::vector<T> &s)
+{
+  assert(player >= 0 && player < numPlayers);
+  static thread_local flat_distrib<T> own;
+  static thread_local std::vector<flat_distrib<T> > strats, products;
+  static thread_local std::vector<std::vector<int> > groups;
+  if ((int) strats.size() < numPlayers) {
+    strats.resize(numPlayers);
+  }
+  //the depth of the recursion over groups is at most one more than the
+  //number of halvings of numPlayers - 1 groups
+  int depth = 1;
+  while ((1 << (depth - 1)) < numPlayers) {
+    depth++;
+  }
+  if ((int) products.size() < 2 * depth) {
+    products.resize(2 * depth);
+  }
+  for (int act = 0; act < actions[player]; ++act) {
+    int Node = actionSets[player][act];
+    dest[act] = computeDistribution(player, act, s).inner_prod(getPayoffTable<T>(Node));
+
+    std::fill(jacobian[act].begin(), jacobian[act].end(), (T) 0);
+    if (numPlayers == 1) {
+      continue;
+    }
+    //In symmetric games, and in k-symmetric games at profiles that are
+    //symmetric within each class, such as those on the principal branch
+    //of the logit correspondence, many players share one group, and the
+    //row is computed from a few distributions only.
+    int numGroups = 0;
+    for (int k = 1; k < numPlayers; k++) {
+      projectStrategy(strats[k], Node, Porder[player][act][k], s);
+      int g = 0;
+      while (g < numGroups &&
+             !isInterchangeable(Node, Porder[player][act][groups[g][0]],
+                                Porder[player][act][k], s)) {
+        g++;
+      }
+      if (g == numGroups) {
+        if (numGroups == (int) groups.size()) {
+          groups.emplace_back();
+        }
+        groups[numGroups++].clear();
+      }
+      groups[g].push_back(k);
+    }
+    own.reset(neighbors[Node].size());
+    own.add(projection[Node][player][act], (T) 1);
+    computeJacobianRow(jacobian[act], player, act, own, strats, groups,
+                       products, 0, numGroups, 0);
+  }
+}
+
+template AggNumber AGG::computeMixedPayoff(int, const std::vector<AggNumber> &);
+template Rational AGG::computeMixedPayoff(int, const std::vector<Rational> &);
+template void AGG::computePayoffVector(std::vector<AggNumber> &, int,
+                                       const std::vector<AggNumber> &);
+template void AGG::computePayoffVector(std::vector<Rational> &, int,
+                                       const std::vector<Rational> &);
+template void AGG::computePayoffJacobian(std::vector<AggNumber> &,
+                                         std::vector<std::vector<AggNumber> > &,
+                                         int, const std::vector<AggNumber> &);
+template void AGG::computePayoffJacobian(std::vector<Rational> &,
+                                         std::vector<std::vector<Rational> > &,
+                                         int, const std::vector<Rational> &);
+
 //getSymMixedPayoff: compute expected payoff under a symmetric mixed strat,
 //  for a symmetric game.
 // parameter: s is the mixed strategy of one player. It is a vector of 
@@ -730,12 +993,14 @@ AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
     int numNei = neighbors[node].size();
 
     if(!isPure[node]){ // then compute EU using trie_map::power()
-      doProjection(node,0,s);
+      Workspace &ws = getWorkspace();
+      std::vector<aggdistrib> &Pr = ws.Pr;
+      doProjection(ws, node,0,s);
       assert(numPlayers>1);
       //aggdistrib *dest;
       //projectedStrat[node][0].power(numPlayers-1, dest, Pr, numNei,projFunctions[node]);
       aggdistrib &dest = Pr[numPlayers-1];
-      projectedStrat[node][0].power(numPlayers-1, dest, Pr[numPlayers-2],numNei,projFunctions[node]);
+      ws.projectedStrat[node][0].power(numPlayers-1, dest, Pr[numPlayers-2],numNei,projFunctions[node]);
       return dest.inner_prod(projection[node][0][node], numNei, projFunctions[node], payoffs[node]);
     }
 
@@ -758,7 +1023,7 @@ AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
     //gray code
     GrayComposition gc (numPlayers-1, support.size() );
 
-    AggNumber prob = pow((support.at(0)>=0)?s[neighbors[node][support[0]]]:null_prob,
+    AggNumber prob = std::pow((support.at(0)>=0)?s[neighbors[node][support[0]]]:null_prob,
 		numPlayers-1);
 
     while (true){
@@ -790,7 +1055,7 @@ AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
 //plClass: the index for the player class
 //s: mixed strat for that player class
 
-void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2){
+void AGG::getSymConfigProb(Workspace &ws, int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2){
     int node = uniqueActionSets.at(ownPlClass).at(act);
     int numPl = playerClasses.at(plClass).size();
     assert(numPl>0);
@@ -805,12 +1070,13 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
 
     if(!isPure[node]){
       int player = playerClasses[plClass].at(0);
-      projectedStrat[node][player].reset();
+      aggdistrib &projected = ws.projectedStrat[node][player];
+      projected.reset();
       if(numPl>0){
         for (int j=0;j<actions[player];j++)if(s[j]>(AggNumber)0.0){
-          projectedStrat[node][player]+= make_pair(projection[node][player][j], s[j]);
+          projected+= make_pair(projection[node][player][j], s[j]);
         }
-        projectedStrat[node][player].power(numPl, dest,Pr[0],numNei, projFunctions[node]);
+        projected.power(numPl, dest,ws.Pr[0],numNei, projFunctions[node]);
       }
       if(plClass==ownPlClass){
         aggdistrib temp;
@@ -864,7 +1130,7 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
     GrayComposition gc (numPl, support.size() );
 
     AggNumber prob0=(support.at(0)>=0)?s[node2Action[neighbors[node].at(support[0])][p]]:null_prob;
-    AggNumber prob = pow(prob0,numPl);
+    AggNumber prob = std::pow(prob0,numPl);
 
     while (true){
       const vector<int>& comp = gc.get();
@@ -924,12 +1190,13 @@ AggNumber AGG::getKSymMixedPayoff(int playerClass, int act, vector<StrategyProfi
       
       int numNei = neighbors[uniqueActionSets[playerClass][act]].size();
 
-      static aggdistrib d,temp;
+      Workspace &ws = getWorkspace();
+      aggdistrib &d = ws.d, &temp = ws.temp;
       d.reset();
       temp.reset();
-      getSymConfigProb(0, s[0], playerClass, act, d);
+      getSymConfigProb(ws, 0, s[0], playerClass, act, d);
       for(int pc=1;pc<numPC;pc++){
-	  getSymConfigProb(pc, s[pc], playerClass, act, temp);
+	  getSymConfigProb(ws, pc, s[pc], playerClass, act, temp);
 	  d.multiply(temp, numNei, projFunctions[uniqueActionSets[playerClass][act]]);
       }
       return d.inner_prod(payoffs[uniqueActionSets[playerClass][act]]);
@@ -938,23 +1205,24 @@ AggNumber AGG::getKSymMixedPayoff(int playerClass, int act, vector<StrategyProfi
 AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2){
   int numPC=playerClasses.size();
   int numNei=neighbors[uniqueActionSets[pClass1][act1]].size();
-  static aggdistrib d,temp;
   if (pClass2>=0 && pClass1==pClass2 && playerClasses.at(pClass1).size()<=1){
     return 0;
   }
+  Workspace &ws = getWorkspace();
+  aggdistrib &d = ws.d, &temp = ws.temp;
   d.reset();
   temp.reset();
   StrategyProfile s0(getNumKSymActions(0), 0.0);
   //if (0==pClass2) s0[act2]=1;
   //else
   for (int a=firstKSymAction(0);a<lastKSymAction(0);++a)s0[a]=s[a];
-  getSymConfigProb(0,s0,pClass1,act1,d,pClass2,act2);
+  getSymConfigProb(ws,0,s0,pClass1,act1,d,pClass2,act2);
   for (int pc=1;pc<numPC;pc++){
     StrategyProfile ss(getNumKSymActions(pc), 0.0);
     //if (pc==pClass2)ss[act2]=1;
     //else
     for (int a=0;a<getNumKSymActions(pc);++a)ss[a]=s[a+firstKSymAction(pc)];
-    getSymConfigProb(pc,ss,pClass1,act1,temp,pClass2,act2);
+    getSymConfigProb(ws,pc,ss,pClass1,act1,temp,pClass2,act2);
     d.multiply(temp,numNei,projFunctions[uniqueActionSets[pClass1][act1]]);
   }
   return d.inner_prod(payoffs[uniqueActionSets[pClass1][act1]]);
@@ -1064,28 +1332,19 @@ void AGG::makeMAPPINGpayoff(std::istream& in, aggpayoff& pay, int numNei){
 }
 
 AggNumber AGG::getMaxPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
   assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
+  AggNumber result=payoffs[0].begin()->second;
+  for (int i=0;i<numActionNodes;i++)
     for (auto it=payoffs[i].begin();it!=payoffs[i].end();++it)
       result=max(result, it->second);
-
-  done=true;
   return result;
 }
 AggNumber AGG::getMinPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
   assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
+  AggNumber result=payoffs[0].begin()->second;
+  for (int i=0;i<numActionNodes;i++)
       for (auto it=payoffs[i].begin();it!=payoffs[i].end();++it)
         result=min(result, it->second);
-  done=true;
   return result;
 }
 
@@ -26,13 +26,17 @@
 
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 #include <iterator>
 #include "proj_func.h"
 #include "trie_map.h"
+#include "flat_distrib.h"
 
 namespace Gambit {
 
+class Rational;
+
 namespace gametracer {
   class aggame;
 }
@@ -98,7 +102,6 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
    std::vector<std::vector<std::vector<config> > >& proj,
    std::vector<std::vector<proj_func*> > & projF,
    std::vector<std::vector<std::vector<int> > >& Po,
-   std::vector<aggdistrib> &P,
       std::vector<aggpayoff>& payoffs);
 
 
@@ -106,18 +109,7 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
 
 
   //destructor
-  virtual ~AGG(){
-      delete [] strategyOffset;
-      //free projFunctions
-      /*
-      for (size_t i=0; i<projFunctions.size(); ++i)
-	  for (size_t j=0;j<projFunctions[i].size(); ++j)
-	      delete projFunctions[i][j];
-      */
-      for (size_t i=0;i<projectionTypes.size();++i){
-        delete projectionTypes[i];
-      }
-  }
+  virtual ~AGG();
 
 
   int getNumPlayers() const {return numPlayers;}
@@ -126,6 +118,7 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   int getMaxActions() const {return maxActions;}
   int firstAction(int i) const {return strategyOffset[i];}
   int lastAction(int i) const {return strategyOffset[i+1];}
+  const ActionSet& getActionSet(int i) const {return actionSets[i];}
 
   int getNumActionNodes() const {return numActionNodes;}
   int getNumFunctionNodes() const {return numPNodes;}
@@ -151,6 +144,33 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   }
 
 
+  //The state changed while evaluating expected payoffs.  Evaluations on
+  //distinct workspaces may run concurrently; the functions below which
+  //take no workspace use one local to the calling thread.
+  struct Workspace {
+    //foreach s \in S, foreach i \in N, the projected mixed strat
+    //which is a prob distribution over the set of 'contributions'
+    std::vector<std::vector<aggdistrib> > projectedStrat;
+
+    //when computing the induced distribution via ComputeP():
+    //foreach k<= n-1,
+    //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
+
+    //when computing the partial distributions for the payoff jacobian:
+    //  foreach  j \in N,
+    // the partial distribution induced by all agents except j.
+    std::vector<aggdistrib> Pr;
+
+    //cache of jacobian entries.
+    trie_map<AggNumber> cache;
+
+    //distributions for k-symmetric payoffs
+    aggdistrib d, temp;
+  };
+
+  //sizes ws for evaluations on this game
+  void initWorkspace(Workspace &ws) const;
+
   //exp. payoff under mixed strat profile
   AggNumber getMixedPayoff(int player, StrategyProfile &s);
   void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s);
@@ -158,6 +178,22 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   AggNumber getJ(int player,int action, int player2,int action2,StrategyProfile &s);
 
 
+  //exp. payoffs under mixed strat profile, in number type T.
+  //These use their own projected strategies and distributions, local to
+  //the calling thread, rather than a workspace.  They are provided for
+  //T = AggNumber and T = Rational; in Rational the payoffs are the
+  //exact values of those stored.
+  template <class T> T computeMixedPayoff(int player, const std::vector<T> &s);
+  template <class T> void computePayoffVector(std::vector<T> &dest, int player,
+                                              const std::vector<T> &s);
+  //computes the payoff vector of the player as computePayoffVector(),
+  //and jacobian[act][k], for each action k (indexed as in s) of each
+  //other player, the expected payoff to act when the owner of k plays it.
+  //Columns of the player's own actions are set to zero.
+  template <class T> void computePayoffJacobian(std::vector<T> &dest,
+                                                std::vector<std::vector<T> > &jacobian,
+                                                int player, const std::vector<T> &s);
+
   AggNumber getPurePayoff(int player, std::vector<int> &s);
   inline void printPayoffs(std::ostream &s, int node){
     s << payoffs.at(node).size()<<std::endl;
@@ -242,10 +278,6 @@ private:
   // the contribution of s' to D^(s)
   //std::vector<std::vector<config> > projection;
 
-  //foreach s \in S, foreach i \in N, the projected mixed strat
-  //which is a prob distribution over the set of 'contributions'
-  std::vector< std::vector<aggdistrib > > projectedStrat;
-
   // foreach s in S, i in N, the full set of projected actions.
   std::vector<std::vector<aggdistrib> >fullProjectedStrat;
 
@@ -256,24 +288,12 @@ private:
   // in which we apply the DP algorithm
   std::vector< std::vector< std::vector<int> > > Porder;
 
-  //when computing the induced distribution via ComputeP():
-  //foreach k<= n-1,  
-  //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
-
-  //when computing the partial distributions for the payoff jacobian:
-  //  foreach  j \in N,
-  // the partial distribution induced by all agents except j. 
-  std::vector<aggdistrib>  Pr;
-
   //foreach s in S, whether s's neighbors are all action nodes
   std::vector<bool> isPure;
 
   //foreach s in S, j in N, the index of s in j's action set, or -1 if N/A
   std::vector<std::vector<int> > node2Action;
 
-  //cache of jacobian entries.
-  trie_map<AggNumber> cache;
-
   //the unique action sets
   std::vector<ActionSet> uniqueActionSets;
 
@@ -289,6 +309,12 @@ private:
   //strategyOffset for kSymmetric strategy profile
   std::vector<int> kSymStrategyOffset;
 
+  //payoffs in flat tables, for the evaluations in number type T,
+  //each built on first use
+  std::vector<flat_distrib<AggNumber> > flatPayoffs;
+  std::vector<flat_distrib<Rational> > rationalPayoffs;
+  std::once_flag flatPayoffsBuilt, rationalPayoffsBuilt;
+
 
   //input functor 
   struct input {
@@ -336,17 +362,41 @@ private:
 
 
   //private methods:
-  void computeP(int player, int act, int player2=-1,int act2=-1);
-  void doProjection(int Node,const StrategyProfile& s){
-	  doProjection (Node, &(const_cast<StrategyProfile &>(s)[0]));
+  //the workspace of the calling thread, sized for this game
+  Workspace &getWorkspace() const;
+
+  void computeP(Workspace &ws, int player, int act, int player2=-1,int act2=-1);
+  void doProjection(Workspace &ws, int Node,const StrategyProfile& s){
+	  doProjection (ws, Node, &(const_cast<StrategyProfile &>(s)[0]));
   }
-  void doProjection(int Node, int player, const StrategyProfile& s){
-	  doProjection(Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
+  void doProjection(Workspace &ws, int Node, int player, const StrategyProfile& s){
+	  doProjection(ws, Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
   }
-  void doProjection(int Node, AggNumber* s);
-  void doProjection(int Node, int player, AggNumber* s);
-
-  void getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1);
+  void doProjection(Workspace &ws, int Node, AggNumber* s);
+  void doProjection(Workspace &ws, int Node, int player, AggNumber* s);
+
+  //payoff function of the action node in number type T
+  template <class T> void buildPayoffTables(std::vector<flat_distrib<T> > &tables) const;
+  template <class T> const flat_distrib<T> &getPayoffTable(int Node);
+  //the distribution of the contributions to Node of player i under s
+  template <class T> void projectStrategy(flat_distrib<T> &dest, int Node, int i,
+                                          const std::vector<T> &s) const;
+  //the distribution of configurations at the node of player's act,
+  //when the other players play s, multiplied in the order of Porder
+  template <class T> const flat_distrib<T> &computeDistribution(int player, int act,
+                                                                const std::vector<T> &s);
+  //whether players p and q may be exchanged in distributions at Node under s
+  template <class T> bool isInterchangeable(int Node, int p, int q,
+                                            const std::vector<T> &s) const;
+  //the entries of a row of the jacobian for a range of groups of players
+  template <class T> void computeJacobianRow(std::vector<T> &row, int player, int act,
+                                             const flat_distrib<T> &outside,
+                                             const std::vector<flat_distrib<T> > &strats,
+                                             const std::vector<std::vector<int> > &groups,
+                                             std::vector<flat_distrib<T> > &products,
+                                             int lo, int hi, int depth);
+
+  void getSymConfigProb(Workspace &ws, int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1);
 };
 
 }  // end namespace Gambit::agg
@@ -4,6 +4,7 @@
 #include <sstream>
 #include <algorithm>
 #include <cassert>
+#include "gambit.h"
 #include "games/agg/bagg.h"
 
 using namespace std;
@@ -245,6 +246,106 @@ void BAGG::getPayoffVector(AggNumberVector &dest, int player,int tp, const Strat
     }
 }
 
+template <class T>
+void BAGG::computeAGGStrat(std::vector<T> &as, const std::vector<T> &s, int player)
+{
+  as.assign(aggPtr->getNumActions(), (T) 0);
+  for (int pl = 0; pl < numPlayers; ++pl) {
+    if (pl == player) continue;
+    for (int t = 0; t < numTypes[pl]; ++t) {
+      T prob = (T) indepTypeDist[pl][t];
+      for (size_t act = 0; act < typeActionSets[pl][t].size(); ++act) {
+        as[typeAction2ActionIndex[pl][t][act] + aggPtr->firstAction(pl)] +=
+          prob * s[act + firstAction(pl, t)];
+      }
+    }
+  }
+}
+
+template <class T>
+T BAGG::computeMixedPayoff(int player, int tp, const std::vector<T> &s)
+{
+  std::vector<T> values(typeActionSets[player][tp].size());
+  computePayoffVector(values, player, tp, s);
+  T result = (T) 0;
+  for (size_t act = 0; act < values.size(); ++act) {
+    if (s[act + firstAction(player, tp)] > (T) 0) {
+      result += s[act + firstAction(player, tp)] * values[act];
+    }
+  }
+  return result;
+}
+
+template <class T>
+void BAGG::computePayoffVector(std::vector<T> &dest, int player, int tp,
+                               const std::vector<T> &s)
+{
+  assert(player>=0&&player < getNumPlayers() && tp>=0 && tp<getNumTypes(player));
+  std::vector<T> as, values(aggPtr->getNumActions(player));
+  computeAGGStrat(as, s, player);
+  aggPtr->computePayoffVector(values, player, as);
+  for (size_t act = 0; act < typeActionSets[player][tp].size(); ++act) {
+    dest[act] = values[typeAction2ActionIndex[player][tp][act]];
+  }
+}
+
+//The AGG jacobian gives the payoff to each action when another player
+//plays a given AGG action; the entry for a type's action is that payoff
+//weighted by the type's probability, plus the payoffs of the player's
+//other types, weighted by theirs.
+template <class T>
+void BAGG::computePayoffJacobian(std::vector<T> &dest, std::vector<std::vector<T> > &jacobian,
+                                 int player, int tp, const std::vector<T> &s)
+{
+  assert(player>=0&&player < getNumPlayers() && tp>=0 && tp<getNumTypes(player));
+  std::vector<T> as;
+  computeAGGStrat(as, s, player);
+  std::vector<T> values(aggPtr->getNumActions(player));
+  std::vector<std::vector<T> > aggJacobian(values.size(),
+                                           std::vector<T>(aggPtr->getNumActions()));
+  aggPtr->computePayoffJacobian(values, aggJacobian, player, as);
+
+  std::vector<T> typeValues;
+  for (size_t act = 0; act < typeActionSets[player][tp].size(); ++act) {
+    const std::vector<T> &row = aggJacobian[typeAction2ActionIndex[player][tp][act]];
+    dest[act] = values[typeAction2ActionIndex[player][tp][act]];
+    std::fill(jacobian[act].begin(), jacobian[act].end(), (T) 0);
+    for (int pl = 0; pl < numPlayers; ++pl) {
+      if (pl == player) continue;
+      typeValues.assign(numTypes[pl], (T) 0);
+      for (int t = 0; t < numTypes[pl]; ++t) {
+        for (size_t a = 0; a < typeActionSets[pl][t].size(); ++a) {
+          typeValues[t] += s[a + firstAction(pl, t)] *
+            row[typeAction2ActionIndex[pl][t][a] + aggPtr->firstAction(pl)];
+        }
+      }
+      for (int t = 0; t < numTypes[pl]; ++t) {
+        T others = (T) 0;
+        for (int t2 = 0; t2 < numTypes[pl]; ++t2) {
+          if (t2 != t) others += (T) indepTypeDist[pl][t2] * typeValues[t2];
+        }
+        for (size_t a = 0; a < typeActionSets[pl][t].size(); ++a) {
+          jacobian[act][a + firstAction(pl, t)] = others + (T) indepTypeDist[pl][t] *
+            row[typeAction2ActionIndex[pl][t][a] + aggPtr->firstAction(pl)];
+        }
+      }
+    }
+  }
+}
+
+template AggNumber BAGG::computeMixedPayoff(int, int, const std::vector<AggNumber> &);
+template Rational BAGG::computeMixedPayoff(int, int, const std::vector<Rational> &);
+template void BAGG::computePayoffVector(std::vector<AggNumber> &, int, int,
+                                        const std::vector<AggNumber> &);
+template void BAGG::computePayoffVector(std::vector<Rational> &, int, int,
+                                        const std::vector<Rational> &);
+template void BAGG::computePayoffJacobian(std::vector<AggNumber> &,
+                                          std::vector<std::vector<AggNumber> > &,
+                                          int, int, const std::vector<AggNumber> &);
+template void BAGG::computePayoffJacobian(std::vector<Rational> &,
+                                          std::vector<std::vector<Rational> > &,
+                                          int, int, const std::vector<Rational> &);
+
 void BAGG::getAGGStrat(StrategyProfile &as, const StrategyProfile &s, int player, int tp, int action){
     for (int i=0;i<aggPtr->getNumActions();++i) as[i]=AggNumber(0.0);
 
@@ -91,6 +91,9 @@ public:
 	  return aggPtr->getMinPayoff();
   }
 
+  //Payoffs are evaluated in the workspace of the underlying AGG which is
+  //local to the calling thread, so threads may evaluate them concurrently.
+
   //exp. payoff under mixed strat profile
   AggNumber getMixedPayoff(int player, StrategyProfile &s);
   //exp payoff for player, conditioned on her receiving type tp.
@@ -99,6 +102,23 @@ public:
   void getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s);
   AggNumber getV (int player, int tp, int action,const StrategyProfile &s);
 
+  //exp. payoffs for player, conditioned on her receiving type tp, in
+  //number type T, evaluated by the templated routines of the underlying
+  //AGG.  They are provided for T = AggNumber and T = Rational; in
+  //Rational the payoffs and type distributions are the exact values of
+  //those stored.
+  template <class T> T computeMixedPayoff(int player, int tp, const std::vector<T> &s);
+  template <class T> void computePayoffVector(std::vector<T> &dest, int player, int tp,
+                                              const std::vector<T> &s);
+  //computes the payoff vector of the player's type tp, as
+  //computePayoffVector(), and jacobian[act][k], for each action k (indexed
+  //as in s) of each type of another player, the expected payoff to act
+  //when that type plays k.  Columns of the player's own types are set to
+  //zero.
+  template <class T> void computePayoffJacobian(std::vector<T> &dest,
+                                                std::vector<std::vector<T> > &jacobian,
+                                                int player, int tp, const std::vector<T> &s);
+
   AggNumber getPurePayoff(int player, int tp, std::vector<int> &s);
   AggNumber getPurePayoff(int player, std::vector<int> &s){
     AggNumber r=0;
@@ -143,6 +163,11 @@ private:
 
   void getAGGStrat(StrategyProfile &as, const StrategyProfile &s, int player=-1, int tp=-1, int action=-1);
   void getSymAGGStrat(StrategyProfile &as, const StrategyProfile &s);
+  //the strategy of the underlying AGG in which each player other than
+  //player plays the mixture of her types' strategies.  The entries of
+  //player's own actions are zero.
+  template <class T> void computeAGGStrat(std::vector<T> &as, const std::vector<T> &s,
+                                          int player);
 
 };
 
@@ -0,0 +1,223 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/agg/flat_distrib.h
+// Distributions over configurations in flat, reusable storage
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_AGG_FLATDISTRIB_H
+#define GAMBIT_AGG_FLATDISTRIB_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "proj_func.h"
+
+namespace Gambit {
+
+namespace agg {
+
+//Mapping from configurations, tuples of keylen ints, to type V.
+//
+//The keys are stored back to back in one array and the values in
+//another, in order of insertion; they are found through an open
+//addressing table of indices into these arrays.  reset() empties the
+//map but keeps all three arrays, so a map which is reset and refilled,
+//as the distributions in the computation of expected payoffs are,
+//allocates only while it grows.
+template <class V> class flat_distrib {
+public:
+  flat_distrib() : keylen(0), count(0), mask(0) { }
+
+  //empties the map, and sets the length of its keys
+  void reset(size_t p_keylen)
+  {
+    keylen = p_keylen;
+    count = 0;
+    std::fill(slots.begin(), slots.end(), -1);
+  }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_t getKeyLength() const { return keylen; }
+  //the key and value of the i'th entry inserted
+  const int *key(size_t i) const { return keys.data() + i * keylen; }
+  const V &value(size_t i) const { return values[i]; }
+
+  //adds v to the value of the key, inserting it if absent
+  void add(const int *p_key, const V &v)
+  {
+    if (slots.empty()) {
+      rehash(16);
+    }
+    int &slot = slots[probe(p_key)];
+    if (slot >= 0) {
+      values[slot] += v;
+      return;
+    }
+    slot = count;
+    if (keys.size() < (count + 1) * keylen) {
+      keys.resize(2 * (count + 1) * keylen);
+    }
+    std::copy(p_key, p_key + keylen, keys.begin() + count * keylen);
+    if (values.size() <= count) {
+      values.push_back(v);
+    }
+    else {
+      values[count] = v;
+    }
+    if (2 * ++count > slots.size()) {
+      rehash(2 * slots.size());
+    }
+  }
+  void add(const std::vector<int> &p_key, const V &v) { add(p_key.data(), v); }
+
+  //the value of the key, or nullptr if absent
+  const V *find(const int *p_key) const
+  {
+    if (slots.empty()) {
+      return nullptr;
+    }
+    int slot = slots[probe(p_key)];
+    return (slot >= 0) ? &values[slot] : nullptr;
+  }
+
+  //polynomial multiplication of t1 and t2, store the result in self
+  void multiply(const flat_distrib<V> &t1, const flat_distrib<V> &t2,
+                const std::vector<proj_func *> &f)
+  {
+    reset(t1.keylen);
+    scratch.resize(keylen);
+    for (size_t i1 = 0; i1 < t1.count; i1++) {
+      if (!(t1.values[i1] > (V) 0)) {
+        continue;
+      }
+      const int *k1 = t1.key(i1);
+      for (size_t i2 = 0; i2 < t2.count; i2++) {
+        if (!(t2.values[i2] > (V) 0)) {
+          continue;
+        }
+        const int *k2 = t2.key(i2);
+        for (size_t i = 0; i < keylen; i++) {
+          scratch[i] = (*f[i])(k1[i], k2[i]);
+        }
+        add(scratch.data(), t1.values[i1] * t2.values[i2]);
+      }
+    }
+  }
+
+  //inner product with the values of the same keys in other
+  V inner_prod(const flat_distrib<V> &other) const
+  {
+    V result(0);
+    for (size_t i = 0; i < count; i++) {
+      if (values[i] > (V) 0) {
+        result += lookup(other, key(i), values[i]);
+      }
+    }
+    return result;
+  }
+
+  //first apply the action x, then inner prod
+  V inner_prod(const std::vector<int> &x, const std::vector<proj_func *> &f,
+               const flat_distrib<V> &other) const
+  {
+    V result(0);
+    std::vector<int> y(keylen);
+    for (size_t i = 0; i < count; i++) {
+      if (values[i] > (V) 0) {
+        const int *k = key(i);
+        for (size_t j = 0; j < keylen; j++) {
+          y[j] = (*f[j])(k[j], x[j]);
+        }
+        result += lookup(other, y.data(), values[i]);
+      }
+    }
+    return result;
+  }
+
+private:
+  size_t keylen, count, mask;
+  //the keys, keylen ints each, and the values, of the entries
+  std::vector<int> keys;
+  std::vector<V> values;
+  //the open addressing table: the index of an entry, or -1
+  std::vector<int> slots;
+  //the key being built by multiply()
+  std::vector<int> scratch;
+
+  static const double THRESH;
+
+  std::size_t hash(const int *p_key) const
+  {
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < keylen; i++) {
+      h = (h ^ (std::uint32_t) p_key[i]) * 0xff51afd7ed558ccdULL;
+    }
+    return (std::size_t) (h ^ (h >> 32));
+  }
+
+  //the slot holding the key, or the empty slot where it belongs
+  size_t probe(const int *p_key) const
+  {
+    for (size_t s = hash(p_key) & mask; ; s = (s + 1) & mask) {
+      if (slots[s] < 0 ||
+          std::equal(p_key, p_key + keylen, key(slots[s]))) {
+        return s;
+      }
+    }
+  }
+
+  void rehash(size_t p_size)
+  {
+    slots.assign(p_size, -1);
+    mask = p_size - 1;
+    for (size_t i = 0; i < count; i++) {
+      size_t s = hash(key(i)) & mask;
+      while (slots[s] >= 0) {
+        s = (s + 1) & mask;
+      }
+      slots[s] = i;
+    }
+  }
+
+  //the product of v with the value of the key in other
+  static V lookup(const flat_distrib<V> &other, const int *p_key, const V &v)
+  {
+    const V *p = other.find(p_key);
+    if (p) {
+      return v * *p;
+    }
+    if (v > (V) THRESH) {
+      std::cout << "inner_prod WARNING: discarding [";
+      std::copy(p_key, p_key + other.keylen, std::ostream_iterator<int>(std::cout, " "));
+      std::cout << "] " << v << std::endl;
+    }
+    return (V) 0;
+  }
+};
+
+template <class V> const double flat_distrib<V>::THRESH = 1e-12;
+
+}  // end namespace Gambit::agg
+
+}  // end namespace Gambit
+
+#endif   // GAMBIT_AGG_FLATDISTRIB_H
@@ -26,6 +26,8 @@
 
 //Mapping from vector of ints to type V.
 //WARNING: traversal using the iterators is in the reverse order of insertion.
+//The products below keep their scratch space in the map receiving the
+//result, so that operations on distinct maps may run concurrently.
 
 #include <cmath>
 #include <list>
@@ -196,8 +198,7 @@ public:
   void multiply (const trie_map<V>& t1,const trie_map<V>& t2,size_t keylen,
 	 std::vector<proj_func*>& f)
   {
-    static size_t i;
-    static std::pair<std::vector<int>, V> v;
+    value_type &v = scratch;
     const_iterator p1,p2;
     //assert(this!=&t1 && this != &t2);
     v.first.resize(keylen);
@@ -205,7 +206,7 @@ public:
     for (p1=t1.begin(); p1!=t1.end(); ++p1)if((*p1).second>(V)0){
       for(p2=t2.begin(); p2!=t2.end(); ++p2)if((*p2).second>(V)0){
 	//assert((*p1).first.size()==keylen&& (*p2).first.size()==keylen);
-	for (i=0;i<keylen;++i){
+	for (size_t i=0;i<keylen;++i){
 	  v.first[i]= (*(f[i])) ((*p1).first[i], (*p2).first[i]);
 	}
 	v.second = (V)((*p1).second * (*p2).second);
@@ -221,7 +222,7 @@ public:
   void multiply_smart (const trie_map<V>& P_k_minus_1,const trie_map<V>& projectedStrat,size_t keylen,
                         std::vector<proj_func*>& f)
         {
-                static std::pair<std::vector<int>, V> v;
+                value_type &v = scratch;
                 v.first.resize(keylen);
                 reset();
 
@@ -276,7 +277,7 @@ public:
 
   //squaring
   void square(trie_map<V>& dest, size_t keylen, std::vector<proj_func*>& f) const{
-    static std::pair<std::vector<int>, V> v;
+    value_type &v = dest.scratch;
     v.first.resize(keylen);
     //assert(this!=&dest);
     dest.reset();
@@ -295,15 +296,14 @@ public:
 
   //squaring in-place
   void square(size_t keylen, std::vector<proj_func*>& f){
-    static typename std::list<typename trie_map<V>::value_type>::iterator p1,p2;
-    static std::pair<std::vector<int>, V> v;
+    value_type &v = scratch;
     v.first.resize(keylen);
-    std::list<typename trie_map<V>::value_type> data2;
-    //data.swap(data2);
-    data2=data;
+    //the current entries are moved aside, and freed once squared
+    std::list<value_type> &data2 = spare;
+    data2.splice(data2.end(), data);
     reset();
-    for(p1=data2.begin();p1!=end();++p1)if((*p1).second>(V)0){
-      for(p2=p1; p2!=data2.end(); ++p2)if((*p2).second>(V)0){
+    for(iterator p1=data2.begin();p1!=data2.end();++p1)if((*p1).second>(V)0){
+      for(iterator p2=p1; p2!=data2.end(); ++p2)if((*p2).second>(V)0){
 	  //assert((*p1).first.size()==keylen&& (*p2).first.size()==keylen);
         for (size_t i=0;i<keylen;++i){
           v.first[i]= (*(f[i])) ((*p1).first[i], (*p2).first[i]);
@@ -313,6 +313,7 @@ public:
         (*this) += v;
       }//end for(p2
     }//end for(p1
+    data2.clear();
   }
 
   //take power of self using repeated squaring. result stored in dest.
@@ -387,27 +388,26 @@ public:
   { 
     V result(init);
     V th(THRESH);
-    static iterator p2;
+    key_type y(keylen);
     //V s(-1);
     for (const_iterator p=begin(); p!=end();++p)if((*p).second>(V)0){
-      value_type y= *p;
-      //assert(y.first.size()==keylen);
+      //assert((*p).first.size()==keylen);
       for (size_t i=0; i<keylen;++i){
-	y.first[i] = (*(f[i])) (y.first[i],x[i]); 
+	y[i] = (*(f[i])) ((*p).first[i],x[i]);
       }
-      //s += y.second;
+      //s += (*p).second;
 
-      p2 = other.find(y.first);
+      iterator p2 = other.find(y);
       //assert(p2!= other.end());
       if (p2==other.end()){
-        if(y.second>th){
+        if((*p).second>th){
 	  std::cout<<"inner_prod WARNING: discarding [";
-	  copy(y.first.begin(),y.first.end(), std::ostream_iterator<int>(std::cout," "));
-	  std::cout<<"] "<<y.second<<std::endl;
+	  copy(y.begin(),y.end(), std::ostream_iterator<int>(std::cout," "));
+	  std::cout<<"] "<<(*p).second<<std::endl;
         }
       }
       else{
-        result += y.second  * (*p2).second;
+        result += (*p).second  * (*p2).second;
       }
     }
 
@@ -430,6 +430,11 @@ private:
 
   std::vector<TrieNode<V>*> leaves;
 
+  //scratch space of the products storing their result in this map:
+  //the entry being added, and the entries replaced by in-place products
+  value_type scratch;
+  std::list<value_type> spare;
+
   static const double  THRESH;
   
   
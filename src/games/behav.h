@@ -23,10 +23,14 @@
 #ifndef LIBGAMBIT_BEHAV_H
 #define LIBGAMBIT_BEHAV_H
 
+#include <vector>
+
 #include "game.h"
 
 namespace Gambit {
 
+struct GameTreeLayout;
+
 ///
 /// MixedBehaviorProfile<T> implements a randomized behavior profile on
 /// an extensive game.
@@ -48,6 +52,9 @@ protected:
   mutable DVector<T> m_actionValues;   // aka conditional payoffs
   mutable DVector<T> m_regret;
 
+  // scratch space for ComputeSolutionData(), indexed as in GameTreeLayout
+  mutable std::vector<T> m_actionProbs, m_infosetProbs;
+
   const T &ActionValue(const GameAction &act) const 
     { return m_actionValues(act->GetInfoset()->GetPlayer()->GetNumber(),
 			    act->GetInfoset()->GetNumber(),
@@ -61,8 +68,8 @@ protected:
   //@{
   void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
   
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  void ComputeSolutionDataPass1(const GameTreeLayout &) const;
+  void ComputeSolutionDataPass2(const GameTreeLayout &) const;
   void ComputeSolutionData() const;
   //@}
 
@@ -0,0 +1,757 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/binfile.cc
+// Compact binary representation of explicit games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#if HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // HAVE_MMAP
+
+#include "gambit.h"
+#include "gametable.h"
+#include "gametree.h"
+
+//
+// The layout of a file is as follows.  Following a header of six 32-bit
+// words, the file consists of arrays, each of which is a 64-bit count
+// of its elements, then the elements, padded with zeros to a multiple
+// of eight bytes.  In order, the arrays are:
+//
+//  - the offsets of the strings in the string data (one more than the
+//    number of strings), and the string data
+//  - for each distinct number, the numerator and denominator of its rational
+//    value, and the index of its text; if the value does not fit in
+//    64 bits, the denominator is zero and the value is taken from the text
+//  - the title, comment, and player labels of the game
+//  - the labels of the outcomes, and their payoffs, as one plane of
+//    number indices per player
+//
+// For a strategic game, these are followed by the numbers of strategies,
+// the labels of the strategies, and the outcome index of each contingency,
+// with the strategy of player 1 changing fastest.  For an extensive game,
+// they are followed by, for each information set, its player (zero for
+// chance), its label and its number of actions; the labels of all the
+// actions, and the indices of their probabilities (chance actions only);
+// and then, for the nodes in preorder, the index of the information set,
+// the label and the index of the outcome.  Outcome and information set
+// indices start from one, with zero meaning none.
+//
+
+namespace Gambit {
+
+namespace {
+
+const char c_signature[8] = { '\x89', 'G', 'B', 'T', 'B', '\r', '\n', '\x1a' };
+const uint32_t c_version = 1;
+const uint32_t c_byteOrder = 0x01020304;
+const uint32_t c_tableGame = 1, c_treeGame = 2;
+/// The probability index of an action which is not at a chance node
+const uint32_t c_noProbability = 0xffffffff;
+/// An unused slot in the hash table of strings, or a string which is not
+/// the text of a number
+const uint32_t c_none = 0xffffffff;
+
+/// Writes an array, which begins and ends on an eight-byte boundary
+template <class T>
+void WriteArray(std::ostream &p_stream, const T *p_data, uint64_t p_count)
+{
+  static const char padding[8] = { 0 };
+  p_stream.write(reinterpret_cast<const char *>(&p_count), sizeof(p_count));
+  p_stream.write(reinterpret_cast<const char *>(p_data), p_count * sizeof(T));
+  p_stream.write(padding, (8 - p_count * sizeof(T) % 8) % 8);
+}
+
+template <class T>
+void WriteArray(std::ostream &p_stream, const std::vector<T> &p_array)
+{ WriteArray(p_stream, p_array.data(), p_array.size()); }
+
+///
+/// A read-only view of an array stored in a file.  Elements are copied
+/// out individually, so that the data need not be aligned.
+///
+template <class T> class FileArray {
+private:
+  const char *m_data;
+  size_t m_length;
+
+public:
+  FileArray() : m_data(nullptr), m_length(0) { }
+  FileArray(const char *p_data, size_t p_length)
+    : m_data(p_data), m_length(p_length) { }
+
+  size_t size() const { return m_length; }
+  const char *data() const { return m_data; }
+  T operator[](size_t i) const
+  { T value;  std::memcpy(&value, m_data + i * sizeof(T), sizeof(T));  return value; }
+};
+
+class BadFileException : public InvalidFileException {
+public:
+  BadFileException()
+    : InvalidFileException("Binary game file is corrupt or truncated") { }
+  ~BadFileException() noexcept override = default;
+};
+
+}  // end anonymous namespace
+
+//========================================================================
+//                      class BinaryGameWriter
+//========================================================================
+
+class BinaryGameWriter {
+private:
+  Game m_game;
+  std::vector<uint64_t> m_stringOffsets;
+  std::string m_stringData;
+  /// An open-addressed hash table of the strings.  There may be as many
+  /// strings as outcomes, and numbers as payoffs, so this avoids
+  /// allocating for each entry, as std::unordered_map would.
+  std::vector<uint32_t> m_stringSlots;
+  std::vector<size_t> m_stringHashes;
+  std::vector<int64_t> m_numerators, m_denominators;
+  std::vector<uint32_t> m_numberText;
+  /// The number whose text is each string
+  std::vector<uint32_t> m_stringNumbers;
+  std::vector<uint32_t> m_outcomeLabels;
+  std::vector<std::vector<uint32_t> > m_payoffs;
+
+  uint32_t AddString(const std::string &);
+  uint32_t AddNumber(const Number &);
+  bool IsString(uint32_t p_index, const std::string &p_string) const;
+  void GrowStringSlots();
+  void AddOutcome(const GameOutcome &);
+  void WriteCommon(std::ostream &, uint32_t p_kind) const;
+
+public:
+  explicit BinaryGameWriter(const Game &p_game)
+    : m_game(p_game), m_stringOffsets(1, 0),
+      m_stringSlots(64, c_none), m_payoffs(p_game->NumPlayers()) { }
+
+  void WriteTable(std::ostream &);
+  void WriteTree(std::ostream &, const GameNode &p_root);
+};
+
+bool BinaryGameWriter::IsString(uint32_t p_index,
+                                const std::string &p_string) const
+{
+  uint64_t start = m_stringOffsets[p_index];
+  uint64_t length = m_stringOffsets[p_index + 1] - start;
+  return (length == p_string.size() &&
+          std::memcmp(m_stringData.data() + start, p_string.data(), length) == 0);
+}
+
+void BinaryGameWriter::GrowStringSlots()
+{
+  std::vector<uint32_t> slots(2 * m_stringSlots.size(), c_none);
+  size_t mask = slots.size() - 1;
+  for (uint32_t index = 0; index < m_stringHashes.size(); index++) {
+    size_t slot = m_stringHashes[index] & mask;
+    while (slots[slot] != c_none) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = index;
+  }
+  m_stringSlots.swap(slots);
+}
+
+uint32_t BinaryGameWriter::AddString(const std::string &p_string)
+{
+  size_t hash = std::hash<std::string>()(p_string);
+  size_t mask = m_stringSlots.size() - 1, slot = hash & mask;
+  for (; m_stringSlots[slot] != c_none; slot = (slot + 1) & mask) {
+    if (IsString(m_stringSlots[slot], p_string)) {
+      return m_stringSlots[slot];
+    }
+  }
+
+  uint32_t index = m_stringHashes.size();
+  m_stringData += p_string;
+  m_stringOffsets.push_back(m_stringData.size());
+  m_stringHashes.push_back(hash);
+  m_stringNumbers.push_back(c_none);
+  m_stringSlots[slot] = index;
+  if (2 * m_stringHashes.size() > m_stringSlots.size()) {
+    GrowStringSlots();
+  }
+  return index;
+}
+
+uint32_t BinaryGameWriter::AddNumber(const Number &p_number)
+{
+  uint32_t text = AddString(static_cast<const std::string &>(p_number));
+  if (m_stringNumbers[text] == c_none) {
+    long num, den;
+    if (static_cast<const Rational &>(p_number).as_long_ratio(num, den)) {
+      m_numerators.push_back(num);
+      m_denominators.push_back(den);
+    }
+    else {
+      m_numerators.push_back(0);
+      m_denominators.push_back(0);
+    }
+    m_stringNumbers[text] = m_numberText.size();
+    m_numberText.push_back(text);
+  }
+  return m_stringNumbers[text];
+}
+
+void BinaryGameWriter::AddOutcome(const GameOutcome &p_outcome)
+{
+  m_outcomeLabels.push_back(AddString(p_outcome->GetLabel()));
+  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
+    m_payoffs[pl - 1].push_back(AddNumber(p_outcome->GetPayoff(pl)));
+  }
+}
+
+void BinaryGameWriter::WriteCommon(std::ostream &p_stream, uint32_t p_kind) const
+{
+  uint32_t header[6] = { 0, 0, c_version, c_byteOrder,
+                         p_kind, static_cast<uint32_t>(m_game->NumPlayers()) };
+  std::memcpy(header, c_signature, sizeof(c_signature));
+  p_stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+  WriteArray(p_stream, m_stringOffsets);
+  WriteArray(p_stream, m_stringData.data(), m_stringData.size());
+  WriteArray(p_stream, m_numerators);
+  WriteArray(p_stream, m_denominators);
+  WriteArray(p_stream, m_numberText);
+}
+
+void BinaryGameWriter::WriteTable(std::ostream &p_stream)
+{
+  auto &table = dynamic_cast<GameTableRep &>(*m_game);
+
+  std::vector<uint32_t> labels, dims, strategies, cells;
+  labels.push_back(AddString(table.GetTitle()));
+  labels.push_back(AddString(table.GetComment()));
+  for (int pl = 1; pl <= table.NumPlayers(); pl++) {
+    GamePlayer player = table.GetPlayer(pl);
+    labels.push_back(AddString(player->GetLabel()));
+    dims.push_back(player->NumStrategies());
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      strategies.push_back(AddString(player->GetStrategy(st)->GetLabel()));
+    }
+  }
+  for (auto &plane : m_payoffs) {
+    plane.reserve(table.NumOutcomes());
+  }
+  for (int outc = 1; outc <= table.NumOutcomes(); outc++) {
+    AddOutcome(table.GetOutcome(outc));
+  }
+  cells.reserve(table.m_results.size());
+  for (auto outcome : table.m_results) {
+    cells.push_back((outcome) ? outcome->GetNumber() : 0);
+  }
+
+  WriteCommon(p_stream, c_tableGame);
+  WriteArray(p_stream, labels);
+  WriteArray(p_stream, m_outcomeLabels);
+  for (const auto &plane : m_payoffs) {
+    WriteArray(p_stream, plane);
+  }
+  WriteArray(p_stream, dims);
+  WriteArray(p_stream, strategies);
+  WriteArray(p_stream, cells);
+}
+
+void BinaryGameWriter::WriteTree(std::ostream &p_stream, const GameNode &p_root)
+{
+  std::vector<uint32_t> labels;
+  labels.push_back(AddString(m_game->GetTitle()));
+  labels.push_back(AddString(m_game->GetComment()));
+  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
+    labels.push_back(AddString(m_game->GetPlayer(pl)->GetLabel()));
+  }
+
+  // As in the .efg format, only the information sets and outcomes which
+  // appear in the tree are written, numbered in order of appearance
+  std::unordered_map<const GameInfosetRep *, uint32_t> infosetIndex;
+  std::unordered_map<const GameOutcomeRep *, uint32_t> outcomeIndex;
+  std::vector<uint32_t> infosetPlayers, infosetLabels, infosetActions;
+  std::vector<uint32_t> actionLabels, actionProbs;
+  std::vector<uint32_t> nodeInfosets, nodeLabels, nodeOutcomes;
+
+  std::vector<GameNode> stack(1, p_root);
+  while (!stack.empty()) {
+    GameNode node = stack.back();
+    stack.pop_back();
+
+    nodeLabels.push_back(AddString(node->GetLabel()));
+    if (node->NumChildren() == 0) {
+      nodeInfosets.push_back(0);
+    }
+    else {
+      GameInfoset infoset = node->GetInfoset();
+      auto entry = infosetIndex.emplace(infoset.operator->(),
+                                        infosetIndex.size() + 1);
+      if (entry.second) {
+        infosetPlayers.push_back((infoset->IsChanceInfoset()) ? 0 :
+                                 infoset->GetPlayer()->GetNumber());
+        infosetLabels.push_back(AddString(infoset->GetLabel()));
+        infosetActions.push_back(infoset->NumActions());
+        for (int act = 1; act <= infoset->NumActions(); act++) {
+          actionLabels.push_back(AddString(infoset->GetAction(act)->GetLabel()));
+          actionProbs.push_back((infoset->IsChanceInfoset()) ?
+                                AddNumber(infoset->GetActionProb(act)) :
+                                c_noProbability);
+        }
+      }
+      nodeInfosets.push_back(entry.first->second);
+      for (int i = node->NumChildren(); i >= 1; i--) {
+        stack.push_back(node->GetChild(i));
+      }
+    }
+
+    GameOutcome outcome = node->GetOutcome();
+    if (outcome) {
+      auto entry = outcomeIndex.emplace(outcome.operator->(),
+                                        outcomeIndex.size() + 1);
+      if (entry.second) {
+        AddOutcome(outcome);
+      }
+      nodeOutcomes.push_back(entry.first->second);
+    }
+    else {
+      nodeOutcomes.push_back(0);
+    }
+  }
+
+  WriteCommon(p_stream, c_treeGame);
+  WriteArray(p_stream, labels);
+  WriteArray(p_stream, m_outcomeLabels);
+  for (const auto &plane : m_payoffs) {
+    WriteArray(p_stream, plane);
+  }
+  WriteArray(p_stream, infosetPlayers);
+  WriteArray(p_stream, infosetLabels);
+  WriteArray(p_stream, infosetActions);
+  WriteArray(p_stream, actionLabels);
+  WriteArray(p_stream, actionProbs);
+  WriteArray(p_stream, nodeInfosets);
+  WriteArray(p_stream, nodeLabels);
+  WriteArray(p_stream, nodeOutcomes);
+}
+
+//========================================================================
+//                      class BinaryGameReader
+//========================================================================
+
+class BinaryGameReader {
+private:
+  const char *m_current, *m_end;
+  uint32_t m_kind;
+  int m_numPlayers;
+  FileArray<uint64_t> m_stringOffsets;
+  FileArray<char> m_stringData;
+  std::vector<Number> m_numbers;
+
+  template <class T> FileArray<T> ReadArray();
+  std::string GetString(uint32_t) const;
+  const Number &GetNumber(uint32_t) const;
+  void ReadNumbers();
+  Array<GameOutcome> ReadOutcomes(Game &);
+  Game ReadTable();
+  Game ReadTree();
+
+public:
+  BinaryGameReader(const char *p_data, size_t p_length);
+
+  Game Read() { return (m_kind == c_tableGame) ? ReadTable() : ReadTree(); }
+};
+
+BinaryGameReader::BinaryGameReader(const char *p_data, size_t p_length)
+  : m_current(p_data), m_end(p_data + p_length)
+{
+  uint32_t header[6];
+  if (!IsBinaryGame(p_data, p_length) || p_length < sizeof(header)) {
+    throw InvalidFileException("Not a binary game file");
+  }
+  std::memcpy(header, p_data, sizeof(header));
+  m_current += sizeof(header);
+  if (header[2] != c_version) {
+    throw InvalidFileException("Unsupported version of binary game file");
+  }
+  if (header[3] != c_byteOrder) {
+    throw InvalidFileException("Binary game file written with different byte order");
+  }
+  m_kind = header[4];
+  if ((m_kind != c_tableGame && m_kind != c_treeGame) || header[5] > 0xffff) {
+    throw BadFileException();
+  }
+  m_numPlayers = header[5];
+
+  m_stringOffsets = ReadArray<uint64_t>();
+  m_stringData = ReadArray<char>();
+  if (m_stringOffsets.size() == 0) {
+    throw BadFileException();
+  }
+  for (size_t i = 1; i < m_stringOffsets.size(); i++) {
+    if (m_stringOffsets[i] < m_stringOffsets[i - 1] ||
+        m_stringOffsets[i] > m_stringData.size()) {
+      throw BadFileException();
+    }
+  }
+  ReadNumbers();
+}
+
+template <class T> FileArray<T> BinaryGameReader::ReadArray()
+{
+  uint64_t count;
+  if (m_end - m_current < static_cast<ptrdiff_t>(sizeof(count))) {
+    throw BadFileException();
+  }
+  std::memcpy(&count, m_current, sizeof(count));
+  m_current += sizeof(count);
+  size_t available = m_end - m_current;
+  if (count > available / sizeof(T)) {
+    throw BadFileException();
+  }
+  // Every array, including the last, is padded to a multiple of 8 bytes,
+  // so a file which ends inside the padding has been truncated
+  size_t bytes = count * sizeof(T);
+  size_t padded = bytes + (8 - bytes % 8) % 8;
+  if (padded > available) {
+    throw BadFileException();
+  }
+  FileArray<T> array(m_current, count);
+  m_current += padded;
+  return array;
+}
+
+std::string BinaryGameReader::GetString(uint32_t p_index) const
+{
+  if (p_index + 1 >= m_stringOffsets.size()) {
+    throw BadFileException();
+  }
+  uint64_t start = m_stringOffsets[p_index];
+  return std::string(m_stringData.data() + start,
+                     m_stringOffsets[p_index + 1] - start);
+}
+
+const Number &BinaryGameReader::GetNumber(uint32_t p_index) const
+{
+  if (p_index >= m_numbers.size()) {
+    throw BadFileException();
+  }
+  return m_numbers[p_index];
+}
+
+void BinaryGameReader::ReadNumbers()
+{
+  auto numerators = ReadArray<int64_t>();
+  auto denominators = ReadArray<int64_t>();
+  auto text = ReadArray<uint32_t>();
+  if (numerators.size() != text.size() || denominators.size() != text.size()) {
+    throw BadFileException();
+  }
+  m_numbers.reserve(text.size());
+  for (size_t i = 0; i < text.size(); i++) {
+    if (denominators[i] > 0) {
+      m_numbers.emplace_back(GetString(text[i]),
+                             Rational(static_cast<long>(numerators[i]),
+                                      static_cast<long>(denominators[i])));
+    }
+    else {
+      m_numbers.emplace_back(GetString(text[i]));
+    }
+  }
+}
+
+Array<GameOutcome> BinaryGameReader::ReadOutcomes(Game &p_game)
+{
+  auto labels = ReadArray<uint32_t>();
+  Array<FileArray<uint32_t> > payoffs(m_numPlayers);
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    payoffs[pl] = ReadArray<uint32_t>();
+    if (payoffs[pl].size() != labels.size()) {
+      throw BadFileException();
+    }
+  }
+
+  Array<GameOutcome> outcomes(labels.size());
+  for (size_t i = 0; i < labels.size(); i++) {
+    GameOutcome outcome = p_game->NewOutcome();
+    outcome->SetLabel(GetString(labels[i]));
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      outcome->m_payoffs[pl] = GetNumber(payoffs[pl][i]);
+    }
+    outcomes[i + 1] = outcome;
+  }
+  return outcomes;
+}
+
+Game BinaryGameReader::ReadTable()
+{
+  auto labels = ReadArray<uint32_t>();
+  if (m_numPlayers < 1 || labels.size() != static_cast<size_t>(m_numPlayers) + 2) {
+    throw BadFileException();
+  }
+  // The dimensions are needed to create the game, and so the outcomes,
+  // which precede them in the file, are returned to afterwards
+  const char *outcomeStart = m_current;
+  ReadArray<uint32_t>();
+  for (int pl = 1; pl <= m_numPlayers; ReadArray<uint32_t>(), pl++);
+
+  auto dims = ReadArray<uint32_t>();
+  auto strategies = ReadArray<uint32_t>();
+  auto cells = ReadArray<uint32_t>();
+  if (dims.size() != static_cast<size_t>(m_numPlayers)) {
+    throw BadFileException();
+  }
+  Array<int> dim(m_numPlayers);
+  uint64_t numStrategies = 0, numContingencies = 1;
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    dim[pl] = dims[pl - 1];
+    if (dim[pl] < 1 || numContingencies > cells.size()) {
+      throw BadFileException();
+    }
+    numStrategies += dim[pl];
+    numContingencies *= dim[pl];
+  }
+  if (strategies.size() != numStrategies || cells.size() != numContingencies) {
+    throw BadFileException();
+  }
+
+  Game game = NewTable(dim, true);
+  auto &table = dynamic_cast<GameTableRep &>(*game);
+  table.SetTitle(GetString(labels[0]));
+  table.SetComment(GetString(labels[1]));
+  for (int pl = 1, st = 0; pl <= m_numPlayers; pl++) {
+    GamePlayer player = table.GetPlayer(pl);
+    player->SetLabel(GetString(labels[pl + 1]));
+    for (int j = 1; j <= dim[pl]; j++) {
+      player->GetStrategy(j)->SetLabel(GetString(strategies[st++]));
+    }
+  }
+
+  const char *tableEnd = m_current;
+  m_current = outcomeStart;
+  Array<GameOutcome> outcomes = ReadOutcomes(game);
+  m_current = tableEnd;
+
+  for (size_t cont = 0; cont < cells.size(); cont++) {
+    uint32_t outcome = cells[cont];
+    if (outcome > static_cast<uint32_t>(outcomes.size())) {
+      throw BadFileException();
+    }
+    table.m_results[cont + 1] = (outcome > 0) ? outcomes[outcome] : nullptr;
+  }
+  table.ClearPayoffCache();
+  return game;
+}
+
+Game BinaryGameReader::ReadTree()
+{
+  auto labels = ReadArray<uint32_t>();
+  if (labels.size() != static_cast<size_t>(m_numPlayers) + 2) {
+    throw BadFileException();
+  }
+
+  Game game = NewTree();
+  auto &tree = dynamic_cast<GameTreeRep &>(*game);
+  tree.SetCanonicalization(false);
+  game->SetTitle(GetString(labels[0]));
+  game->SetComment(GetString(labels[1]));
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    game->NewPlayer()->SetLabel(GetString(labels[pl + 1]));
+  }
+  Array<GameOutcome> outcomes = ReadOutcomes(game);
+
+  auto infosetPlayers = ReadArray<uint32_t>();
+  auto infosetLabels = ReadArray<uint32_t>();
+  auto infosetActions = ReadArray<uint32_t>();
+  auto actionLabels = ReadArray<uint32_t>();
+  auto actionProbs = ReadArray<uint32_t>();
+  auto nodeInfosets = ReadArray<uint32_t>();
+  auto nodeLabels = ReadArray<uint32_t>();
+  auto nodeOutcomes = ReadArray<uint32_t>();
+  if (infosetLabels.size() != infosetPlayers.size() ||
+      infosetActions.size() != infosetPlayers.size() ||
+      actionProbs.size() != actionLabels.size() ||
+      nodeLabels.size() != nodeInfosets.size() ||
+      nodeOutcomes.size() != nodeInfosets.size()) {
+    throw BadFileException();
+  }
+
+  // The position of the first action of each information set
+  std::vector<size_t> actionStart(infosetActions.size() + 1, 0);
+  for (size_t i = 0; i < infosetActions.size(); i++) {
+    if (infosetActions[i] < 1 || infosetPlayers[i] > static_cast<uint32_t>(m_numPlayers)) {
+      throw BadFileException();
+    }
+    actionStart[i + 1] = actionStart[i] + infosetActions[i];
+  }
+  if (actionStart.back() != actionLabels.size()) {
+    throw BadFileException();
+  }
+
+  std::vector<GameInfoset> infosets(infosetPlayers.size());
+  std::vector<GameNode> stack(1, game->GetRoot());
+  for (size_t i = 0; i < nodeInfosets.size(); i++) {
+    if (stack.empty()) {
+      throw BadFileException();
+    }
+    GameNode node = stack.back();
+    stack.pop_back();
+    node->SetLabel(GetString(nodeLabels[i]));
+
+    if (nodeInfosets[i] > 0) {
+      size_t index = nodeInfosets[i] - 1;
+      if (index >= infosets.size()) {
+        throw BadFileException();
+      }
+      GameInfoset &infoset = infosets[index];
+      if (infoset) {
+        node->AppendMove(infoset);
+      }
+      else {
+        GamePlayer player = (infosetPlayers[index] == 0) ? game->GetChance() :
+          game->GetPlayer(infosetPlayers[index]);
+        infoset = node->AppendMove(player, infosetActions[index]);
+        infoset->SetLabel(GetString(infosetLabels[index]));
+        for (int act = 1; act <= infoset->NumActions(); act++) {
+          infoset->GetAction(act)->SetLabel(GetString(actionLabels[actionStart[index] + act - 1]));
+        }
+        if (player == game->GetChance()) {
+          Array<Number> probs(infoset->NumActions());
+          for (int act = 1; act <= probs.Length(); act++) {
+            probs[act] = GetNumber(actionProbs[actionStart[index] + act - 1]);
+          }
+          game->SetChanceProbs(infoset, probs);
+        }
+      }
+      for (int j = node->NumChildren(); j >= 1; j--) {
+        stack.push_back(node->GetChild(j));
+      }
+    }
+
+    uint32_t outcome = nodeOutcomes[i];
+    if (outcome > static_cast<uint32_t>(outcomes.size())) {
+      throw BadFileException();
+    }
+    if (outcome > 0) {
+      node->SetOutcome(outcomes[outcome]);
+    }
+  }
+  if (!stack.empty()) {
+    throw BadFileException();
+  }
+
+  tree.SetCanonicalization(true);
+  return game;
+}
+
+//========================================================================
+//                    Reading and writing binary files
+//========================================================================
+
+bool IsBinaryGame(const char *p_data, size_t p_length)
+{
+  return (p_length >= sizeof(c_signature) &&
+          std::memcmp(p_data, c_signature, sizeof(c_signature)) == 0);
+}
+
+void WriteBinaryGame(std::ostream &p_stream, const Game &p_game)
+{
+  if (p_game->IsTree()) {
+    BinaryGameWriter(p_game).WriteTree(p_stream, p_game->GetRoot());
+  }
+  else if (dynamic_cast<GameTableRep *>(p_game.operator->())) {
+    BinaryGameWriter(p_game).WriteTable(p_stream);
+  }
+  else {
+    throw UndefinedException();
+  }
+}
+
+void WriteBinaryGame(std::ostream &p_stream, const GameNode &p_root)
+{
+  BinaryGameWriter(p_root->GetGame()).WriteTree(p_stream, p_root);
+}
+
+Game ReadBinaryGame(const char *p_data, size_t p_length)
+{
+  return BinaryGameReader(p_data, p_length).Read();
+}
+
+namespace {
+
+#if HAVE_MMAP
+/// A read-only mapping of a file into memory, released on destruction
+class MappedFile {
+private:
+  void *m_data;
+  size_t m_length;
+
+public:
+  explicit MappedFile(const std::string &p_filename)
+    : m_data(MAP_FAILED), m_length(0)
+  {
+    int fd = open(p_filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+      m_length = info.st_size;
+      m_data = mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+  }
+  ~MappedFile()  { if (IsMapped()) munmap(m_data, m_length); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool IsMapped() const { return m_data != MAP_FAILED; }
+  const char *GetData() const { return static_cast<const char *>(m_data); }
+  size_t GetLength() const { return m_length; }
+};
+#endif  // HAVE_MMAP
+
+}  // end anonymous namespace
+
+Game ReadGame(const std::string &p_filename)
+{
+#if HAVE_MMAP
+  {
+    MappedFile file(p_filename);
+    if (file.IsMapped() && IsBinaryGame(file.GetData(), file.GetLength())) {
+      return ReadBinaryGame(file.GetData(), file.GetLength());
+    }
+  }
+#endif  // HAVE_MMAP
+  std::ifstream file(p_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    throw InvalidFileException("Unable to open file '" + p_filename + "'");
+  }
+  return ReadGame(file);
+}
+
+}  // end namespace Gambit
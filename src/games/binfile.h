@@ -0,0 +1,63 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/binfile.h
+// Compact binary representation of explicit games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_BINFILE_H
+#define LIBGAMBIT_BINFILE_H
+
+#include <cstddef>
+#include <iostream>
+
+namespace Gambit {
+
+///
+/// @name The binary game format (.gbtb)
+///
+/// A binary file holds a strategic or extensive game as a sequence of
+/// flat arrays of fixed-width integers: a table of the distinct strings
+/// and payoff values in the game, the payoff planes of the outcomes, and
+/// either the outcome index of each contingency of a table or the nodes
+/// of a tree in preorder.  Numbers are stored with both their text and,
+/// where it fits in 64 bits, their rational value, so no text needs to
+/// be parsed on reading.  The arrays are aligned so that they can be
+/// used in place from a memory-mapped file.
+///
+/// Files are written in the byte order of the machine; a file with a
+/// different byte order is rejected when read.
+///
+//@{
+/// Returns true if the data begins with the signature of a binary file
+bool IsBinaryGame(const char *p_data, size_t p_length);
+/// Returns true if the first byte of a binary file is c
+inline bool IsBinaryGameStart(int c) { return c == 0x89; }
+
+/// Writes the game in binary format to the stream
+void WriteBinaryGame(std::ostream &, const Game &);
+/// Writes the subtree rooted at the node, as a game, in binary format
+void WriteBinaryGame(std::ostream &, const GameNode &p_root);
+
+/// Constructs a game from binary data held in memory
+Game ReadBinaryGame(const char *p_data, size_t p_length);
+//@}
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_BINFILE_H
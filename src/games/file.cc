@@ -45,9 +45,15 @@ typedef enum {
 //! including the nonsignificance of whitespace and the possibility of
 //! escaped-quotes within text labels.
 //!
+//! Characters are taken directly from the stream's buffer, rather than
+//! through the formatted-input layer of the stream, so that the file is
+//! read in a single buffered pass.  The stream is left positioned just
+//! after the last token read.
+//!
 class GameParserState {
 private:
-  std::istream &m_file;
+  std::streambuf *m_buffer;
+  bool m_eof;
 
   int m_currentLine;
   int m_currentColumn;
@@ -60,7 +66,8 @@ private:
 
 public:
   explicit GameParserState(std::istream &p_file) :
-    m_file(p_file), m_currentLine(1), m_currentColumn(1) { }
+    m_buffer(p_file.rdbuf()), m_eof(false),
+    m_currentLine(1), m_currentColumn(1) { }
 
   GameFileToken GetNextToken();
   GameFileToken GetCurrentToken() const { return m_lastToken; }
@@ -70,16 +77,28 @@ public:
   const std::string &GetLastText() const { return m_lastText; }
 };
 
+//
+// At the end of the file, c is set to a null character, which is neither
+// whitespace nor part of any token, and further reads have no effect.
+//
 void GameParserState::ReadChar(char& c)
 {
-  m_file.get(c);
+  int ch = m_buffer->sbumpc();
+  if (ch == std::char_traits<char>::eof()) {
+    m_eof = true;
+    c = '\0';
+    return;
+  }
+  c = std::char_traits<char>::to_char_type(ch);
   m_currentColumn++;
 }
 
 void GameParserState::UnreadChar()
 {
-  m_file.unget();
-  m_currentColumn--;
+  if (!m_eof) {
+    m_buffer->sungetc();
+    m_currentColumn--;
+  }
 }
 
 void GameParserState::IncreaseLine(){
@@ -91,13 +110,13 @@ void GameParserState::IncreaseLine(){
 GameFileToken GameParserState::GetNextToken()
 {
   char c = ' ';
-  if (m_file.eof()) {
+  if (m_eof) {
     return (m_lastToken = TOKEN_EOF);
   }
 
   while (isspace(c)) {
     ReadChar(c);
-    if (!m_file.good()) {
+    if (m_eof) {
       return (m_lastToken = TOKEN_EOF);
     }
     else if (c == '\n') {
@@ -115,17 +134,17 @@ GameFileToken GameParserState::GetNextToken()
     return (m_lastToken = TOKEN_COMMA);
   }
   else if (isdigit(c) || c == '-' || c == '+') {
-    std::string buf;
-    buf += c;
+    // The token is accumulated in place, reusing the buffer's storage
+    std::string &buf = m_lastText;
+    buf = c;
     ReadChar(c);
 
-    while (!m_file.eof() && m_file.good() && isdigit(c)) {
+    while (isdigit(c)) {
       buf += c;
       ReadChar(c);
     }
 
-    if (m_file.eof() || !m_file.good()) {
-      m_lastText = buf;
+    if (m_eof) {
       return (m_lastToken = TOKEN_NUMBER);
     }
 
@@ -152,7 +171,6 @@ GameFileToken GameParserState::GetNextToken()
       }
 
       UnreadChar();
-      m_lastText = buf;
 
       return (m_lastToken = TOKEN_NUMBER);
     }
@@ -164,7 +182,6 @@ GameFileToken GameParserState::GetNextToken()
         ReadChar(c);
       }
       UnreadChar();
-      m_lastText = buf;
       return (m_lastToken = TOKEN_NUMBER);
     }
     else if (c == 'e' || c == 'E') {
@@ -180,18 +197,16 @@ GameFileToken GameParserState::GetNextToken()
         ReadChar(c);
       }
       UnreadChar();
-      m_lastText = buf;
       return (m_lastToken = TOKEN_NUMBER);
     }
     else {
       UnreadChar();
-      m_lastText = buf;
       return (m_lastToken = TOKEN_NUMBER);
     }
   }
   else if (c == '.') {
-    std::string buf;
-    buf += c;
+    std::string &buf = m_lastText;
+    buf = c;
     ReadChar(c);
 
     while (isdigit(c)) {
@@ -199,7 +214,6 @@ GameFileToken GameParserState::GetNextToken()
       ReadChar(c);
     }
     UnreadChar();
-    m_lastText = buf;
     return (m_lastToken = TOKEN_NUMBER);
   }
 
@@ -223,7 +237,7 @@ GameFileToken GameParserState::GetNextToken()
 
       ReadChar(a);
       while  (a != '\"' || lastslash)  {
-	if (m_file.eof() || !m_file.good())  {
+	if (m_eof)  {
 	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
 	}
         if (lastslash && a == '"') {
@@ -244,7 +258,7 @@ GameFileToken GameParserState::GetNextToken()
       do  {
       	m_lastText += a;
         ReadChar(a);
-	if (m_file.eof() || !m_file.good())  {
+	if (m_eof)  {
 	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
 	}
         if (a == '\n') {
@@ -257,7 +271,7 @@ GameFileToken GameParserState::GetNextToken()
   }
 
   m_lastText = "";
-  while (!isspace(c) && !m_file.eof()) {
+  while (!isspace(c) && !m_eof) {
     m_lastText += c;
     ReadChar(c);
   }
@@ -601,20 +615,28 @@ void ParseOutcomeBody(GameParserState &p_parser, Game &p_nfg)
 
 void ParsePayoffBody(GameParserState &p_parser, Game &p_nfg)
 {
-  StrategySupportProfile profile(p_nfg);
-  StrategyProfileIterator iter(profile);
-  int pl = 1;
+  // In a newly-created table, each contingency has its own outcome, and
+  // these are numbered in the order in which the contingencies are
+  // listed in the file, with player 1's strategy changing fastest.
+  // Payoffs are therefore written directly to the outcomes in turn.
+  int pl = 1, numPlayers = p_nfg->NumPlayers();
+  int cont = 1, numContingencies = p_nfg->NumOutcomes();
+  GameOutcome outcome;
 
   while (p_parser.GetCurrentToken() != TOKEN_EOF) {
-    if (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-      (*iter)->GetOutcome()->SetPayoff(pl, Number(p_parser.GetLastText()));
-    }
-    else {
+    if (p_parser.GetCurrentToken() != TOKEN_NUMBER) {
       throw InvalidFileException(p_parser.CreateLineMsg("Expecting payoff"));
     }
+    if (pl == 1) {
+      if (cont > numContingencies) {
+        throw InvalidFileException(p_parser.CreateLineMsg("Too many payoffs"));
+      }
+      outcome = p_nfg->GetOutcome(cont);
+    }
+    outcome->SetPayoff(pl, Number(p_parser.GetLastText()));
 
-    if (++pl > p_nfg->NumPlayers()) {
-      iter++;
+    if (++pl > numPlayers) {
+      cont++;
       pl = 1;
     }
     p_parser.GetNextToken();
@@ -1050,17 +1072,24 @@ Game GameXMLSavefile::GetGame() const
 
 Game ReadGame(std::istream &p_file)
 {
-  std::stringstream buffer;
-  buffer << p_file.rdbuf();
-  try {
+  // An XML document or binary file is recognized by its first
+  // non-whitespace character.  Only then is the file read into memory;
+  // the other formats are parsed in a single pass directly from the stream.
+  p_file >> std::ws;
+  if (p_file.peek() == '<') {
+    std::stringstream buffer;
+    buffer << p_file.rdbuf();
     GameXMLSavefile doc(buffer.str());
     return doc.GetGame();
   }
-  catch (InvalidFileException &) {
-    buffer.seekg(0, std::ios::beg);
+  if (IsBinaryGameStart(p_file.peek())) {
+    std::stringstream buffer;
+    buffer << p_file.rdbuf();
+    std::string data = buffer.str();
+    return ReadBinaryGame(data.data(), data.size());
   }
 
-  GameParserState parser(buffer);
+  GameParserState parser(p_file);
   try {
     if (parser.GetNextToken() != TOKEN_SYMBOL) {
       throw InvalidFileException(parser.CreateLineMsg("Expecting file type"));
@@ -1080,10 +1109,10 @@ Game ReadGame(std::istream &p_file)
       return game;
     }
     else if (parser.GetLastText() == "#AGG") {
-      return GameAggRep::ReadAggFile(buffer);
+      return GameAggRep::ReadAggFile(p_file);
     }
     else if (parser.GetLastText() == "#BAGG") {
-      return GameBagentRep::ReadBaggFile(buffer);
+      return GameBagentRep::ReadBaggFile(p_file);
     }
     else {
       throw InvalidFileException("Tokens 'EFG' or 'NFG' or '#AGG' or '#BAGG' expected at start of file");
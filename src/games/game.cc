@@ -45,6 +45,7 @@ GameOutcomeRep::GameOutcomeRep(GameRep *p_game, int p_number)
 
 void GameStrategyRep::DeleteStrategy()
 {
+  if (m_player->GetGame()->IsFrozen()) throw FrozenGameException();
   if (m_player->GetGame()->IsTree())  throw UndefinedException();
   if (m_player->NumStrategies() == 1)  return;
 
@@ -82,6 +83,7 @@ GamePlayerRep::~GamePlayerRep()
 
 GameStrategy GamePlayerRep::NewStrategy()
 {
+  if (m_game->IsFrozen()) throw FrozenGameException();
   if (m_game->IsTree())  throw UndefinedException();
 
   auto *strategy = new GameStrategyRep(this);
@@ -185,7 +187,7 @@ void GamePlayerRep::MakeReducedStrats(GameTreeNodeRep *n, GameTreeNodeRep *nn)
   }
 }
 
-GameInfoset GamePlayerRep::GetInfoset(int p_index) const { return m_infosets[p_index]; }
+GameInfosetRep *GamePlayerRep::GetInfoset(int p_index) const { return m_infosets[p_index]; }
 
 
 //========================================================================
@@ -289,7 +291,7 @@ PureBehaviorProfile::PureBehaviorProfile(Game p_efg)
 {
   for (int pl = 1; pl <= m_efg->NumPlayers(); pl++)  {
     GamePlayerRep *player = m_efg->GetPlayer(pl);
-    m_profile[pl] = Array<GameAction>(player->NumInfosets());
+    m_profile[pl] = Array<GameActionRep *>(player->NumInfosets());
     for (int iset = 1; iset <= player->NumInfosets(); iset++) {
       m_profile[pl][iset] = player->GetInfoset(iset)->GetAction(1);
     }
@@ -315,9 +317,13 @@ template <class T>
 T PureBehaviorProfile::GetPayoff(const GameNode &p_node,
 				 int pl) const
 {
-  T payoff(0);
+  return GetPayoff<T>(dynamic_cast<GameTreeNodeRep *>(p_node.operator->()), pl);
+}
 
-  auto *node = dynamic_cast<GameTreeNodeRep *>(p_node.operator->());
+template <class T> 
+T PureBehaviorProfile::GetPayoff(const GameTreeNodeRep *node, int pl) const
+{
+  T payoff(0);
 
   if (node->outcome) {
     payoff += static_cast<T>(node->outcome->GetPayoff(pl));
@@ -393,6 +399,19 @@ PureBehaviorProfile::ToMixedBehaviorProfile() const
 //                            class GameRep
 //========================================================================
 
+//------------------------------------------------------------------------
+//                         GameRep: Lifecycle
+//------------------------------------------------------------------------
+
+Game GameRep::Freeze()
+{
+  if (!m_frozen) {
+    BuildComputedValues();
+    m_frozen = true;
+  }
+  return this;
+}
+
 //------------------------------------------------------------------------
 //                     GameRep: Writing data files
 //------------------------------------------------------------------------
@@ -542,7 +561,7 @@ Array<int> GameExplicitRep::NumStrategies() const
   return dim;
 }
 
-GameStrategy GameExplicitRep::GetStrategy(int p_index) const
+GameStrategyRep *GameExplicitRep::GetStrategy(int p_index) const
 {
   const_cast<GameExplicitRep *>(this)->BuildComputedValues();
   for (int pl = 1, i = 1; pl <= m_players.Length(); pl++) {
@@ -580,6 +599,7 @@ int GameExplicitRep::MixedProfileLength() const
 
 GameOutcome GameExplicitRep::NewOutcome()
 {
+  if (m_frozen) throw FrozenGameException();
   m_outcomes.push_back(new GameOutcomeRep(this, m_outcomes.size() + 1));
   return m_outcomes.back();
 }
@@ -599,6 +619,9 @@ void GameExplicitRep::Write(std::ostream &p_stream,
 	   (p_format == "native" && !IsTree())) {
     WriteNfgFile(p_stream);
   }
+  else if (p_format == "gbtb") {
+    WriteBinaryGame(p_stream, Game(const_cast<GameExplicitRep *>(this)));
+  }
   else {
     throw UndefinedException();
   }
@@ -25,6 +25,7 @@
 #define LIBGAMBIT_GAME_H
 
 #include <memory>
+#include <atomic>
 #include "core/dvector.h"
 #include "number.h"
 
@@ -39,9 +40,13 @@ namespace Gambit {
 /// but will instead be marked as deleted.  Calling code should always
 /// be careful to check the deleted status of the object before any
 /// operations on it.
+///
+/// The reference count is atomic, so that handles to the objects of a
+/// game may be copied and released concurrently by several threads
+/// which only read the game.
 class GameObject {
 protected:
-  int m_refCount;
+  std::atomic<int> m_refCount;
   bool m_valid;
 
 public:
@@ -65,18 +70,19 @@ public:
   /// @name Reference counting
   //@{
   /// Increment the reference count
-  void IncRef() { m_refCount++; }
+  void IncRef() { m_refCount.fetch_add(1, std::memory_order_relaxed); }
   /// Decrement the reference count; delete if reference count is zero.
-  void DecRef() { if (!--m_refCount && !m_valid) delete this; }
+  void DecRef()
+  { if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1 && !m_valid) delete this; }
   /// Returns the reference count
-  int RefCount() const { return m_refCount; }
+  int RefCount() const { return m_refCount.load(std::memory_order_relaxed); }
   //@}
 };
 
 
 class BaseGameRep {
 protected:
-    int m_refCount;
+    std::atomic<int> m_refCount;
 
 public:
     /// @name Lifecycle
@@ -99,11 +105,12 @@ public:
     /// @name Reference counting
     //@{
     /// Increment the reference count
-    void IncRef() { m_refCount++; }
+    void IncRef() { m_refCount.fetch_add(1, std::memory_order_relaxed); }
     /// Decrement the reference count; delete if reference count is zero.
-    void DecRef() { if (!--m_refCount) delete this; }
+    void DecRef()
+    { if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this; }
     /// Returns the reference count
-    int RefCount() const { return m_refCount; }
+    int RefCount() const { return m_refCount.load(std::memory_order_relaxed); }
     //@}
 };
 
@@ -120,6 +127,14 @@ public:
 // member objects of games.  It takes care of all the reference-counting
 // considerations.
 //
+// Accessors which look up an object the game already holds by its
+// index, such as GameRep::GetPlayer() or GamePlayerRep::GetStrategy(),
+// return a plain (borrowed) pointer, which does not touch the reference
+// count; it is converted to a handle only where the caller keeps it.
+// Accessors whose result may be null, such as the navigation functions
+// of nodes, and accessors which create or restructure objects, return
+// handles, so that using a null or deleted result raises an exception.
+//
 template <class T> class GameObjectPtr {
 private:
   T *rep;
@@ -129,6 +144,8 @@ public:
     { if (rep) rep->IncRef(); }
   GameObjectPtr(const GameObjectPtr<T> &r) : rep(r.rep)
     { if (rep) rep->IncRef(); }
+  GameObjectPtr(GameObjectPtr<T> &&r) noexcept : rep(r.rep)
+    { r.rep = nullptr; }
   ~GameObjectPtr() { if (rep) rep->DecRef(); }
 
   GameObjectPtr<T> &operator=(const GameObjectPtr<T> &r)
@@ -139,6 +156,14 @@ public:
       }
       return *this;
     }
+  GameObjectPtr<T> &operator=(GameObjectPtr<T> &&r) noexcept
+    { if (&r != this) {
+	if (rep) rep->DecRef();
+	rep = r.rep;
+	r.rep = nullptr;
+      }
+      return *this;
+    }
 
   T *operator->() const 
     { if (!rep) throw NullException();
@@ -215,6 +240,14 @@ public:
   { return "Operation between objects in different games"; }
 };
 
+/// Exception thrown on an attempt to change a frozen game
+class FrozenGameException : public Exception {
+public:
+  ~FrozenGameException() noexcept override = default;
+  const char *what() const noexcept override  
+  { return "Attempted to change a frozen game"; }
+};
+
 /// Exception thrown on a parse error when reading a game savefile
 class InvalidFileException : public Exception {
 public:
@@ -237,6 +270,7 @@ class GameOutcomeRep : public GameObject  {
   friend class GameTreeRep;
   friend class GameTableRep;
   friend class TableFileGameRep;
+  friend class BinaryGameReader;
 
 private:
   GameRep *m_game;
@@ -269,8 +303,7 @@ public:
   /// Gets the payoff associated with the outcome to the player
   const Number &GetPayoff(const GamePlayer &p_player) const;
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const Number &p_value)
-    { m_payoffs[pl] = p_value; }
+  void SetPayoff(int pl, const Number &p_value);
   /// Sets the payoff to the player
   void SetPayoff(const GamePlayer &p_player, const Number &p_value);
 
@@ -287,7 +320,7 @@ protected:
 
 public:
   virtual int GetNumber() const = 0;
-  virtual GameInfoset GetInfoset() const = 0;
+  virtual GameInfosetRep *GetInfoset() const = 0;
 
   virtual const std::string &GetLabel() const = 0;
   virtual void SetLabel(const std::string &p_label) = 0;
@@ -308,7 +341,7 @@ public:
   virtual Game GetGame() const = 0;
   virtual int GetNumber() const = 0;
   
-  virtual GamePlayer GetPlayer() const = 0;
+  virtual GamePlayerRep *GetPlayer() const = 0;
   virtual void SetPlayer(GamePlayer p) = 0;
 
   virtual bool IsChanceInfoset() const = 0;
@@ -323,7 +356,7 @@ public:
   /// Returns the number of actions available at the information set
   virtual int NumActions() const = 0;
   /// Returns the p_index'th action at the information set
-  virtual GameAction GetAction(int p_index) const = 0;
+  virtual GameActionRep *GetAction(int p_index) const = 0;
   /// Returns a forward iterator over the available actions
   //virtual GameActionIterator Actions(void) const = 0; 
   //@}
@@ -359,6 +392,7 @@ class GameStrategyRep : public GameObject  {
   friend class StrategySupportProfile;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
+  template <class T> friend class TreeMixedStrategyProfileRep;
   template <class T> friend class MixedBehaviorProfile;
 
 private:
@@ -384,7 +418,7 @@ public:
   void SetLabel(const std::string &p_label) { m_label = p_label; }
   
   /// Returns the player for whom this is a strategy
-  GamePlayer GetPlayer() const;
+  GamePlayerRep *GetPlayer() const;
   /// Returns the index of the strategy for its player
   int GetNumber() const { return m_number; }
   /// Returns the global number of the strategy in the game
@@ -444,14 +478,14 @@ public:
   /// Returns the number of information sets at which the player makes a choice
   int NumInfosets() const { return m_infosets.size(); }
   /// Returns the p_index'th information set
-  GameInfoset GetInfoset(int p_index) const;
+  GameInfosetRep *GetInfoset(int p_index) const;
 
   /// @name Strategies
   //@{
   /// Returns the number of strategies available to the player
   int NumStrategies() const; 
   /// Returns the st'th strategy for the player
-  GameStrategy GetStrategy(int st) const;
+  GameStrategyRep *GetStrategy(int st) const;
   /// Returns the array of strategies available to the player
   const GameStrategyArray &Strategies() const;
   /// Creates a new strategy for the player
@@ -604,7 +638,9 @@ public:
 class PureBehaviorProfile {
 private:
   Game m_efg;
-  Array<Array<GameAction> > m_profile;
+  Array<Array<GameActionRep *> > m_profile;
+
+  template <class T> T GetPayoff(const GameTreeNodeRep *, int pl) const;
 
 public:
   /// @name Lifecycle
@@ -641,6 +677,7 @@ public:
 
 /// This is the class for representing an arbitrary finite game.
 class GameRep : public BaseGameRep {
+  friend class GameOutcomeRep;
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
@@ -652,6 +689,8 @@ class GameRep : public BaseGameRep {
 
 protected:
   std::string m_title, m_comment;
+  /// Set once Freeze() has been called
+  bool m_frozen{false};
 
   GameRep() = default;
 
@@ -665,6 +704,8 @@ protected:
   virtual void BuildComputedValues() { }
   /// Have computed values been built?
   virtual bool HasComputedValues() const { return false; }
+  /// Clear out any cached payoff data after payoffs or outcomes change
+  virtual void ClearPayoffCache() const { }
   //@}
 
 public:
@@ -729,6 +770,15 @@ public:
   ~GameRep() override = default;
   /// Create a copy of the game, as a new game
   virtual Game Copy() const = 0;
+  /// Build every value which is otherwise computed on first use
+  /// (reduced strategies, canonical numbering, payoff tables), and mark
+  /// the game as frozen.  Const member functions of a frozen game in
+  /// explicit (table or tree) form only read it, so any number of solvers
+  /// may share it concurrently.  Changing the structure or payoffs of a
+  /// frozen game raises a FrozenGameException, and leaves the game as it was.
+  virtual Game Freeze();
+  /// Has the game been frozen?
+  bool IsFrozen() const { return m_frozen; }
   //@}
 
   /// @name General data access
@@ -783,7 +833,7 @@ public:
   /// The number of strategies for each player
   virtual Array<int> NumStrategies() const = 0;
   /// Gets the i'th strategy in the game, numbered globally
-  virtual GameStrategy GetStrategy(int p_index) const = 0;
+  virtual GameStrategyRep *GetStrategy(int p_index) const = 0;
   /// Returns the number of strategy contingencies in the game
   virtual int NumStrategyContingencies() const = 0;
   /// Returns the total number of actions in the game
@@ -803,12 +853,12 @@ public:
   /// Returns the number of players in the game
   virtual int NumPlayers() const = 0;
   /// Returns the pl'th player in the game
-  virtual GamePlayer GetPlayer(int pl) const = 0;
+  virtual GamePlayerRep *GetPlayer(int pl) const = 0;
   /// Returns the set of players in the game 
   Players GetPlayers()
   { return Players(Game(this)); }
   /// Returns the chance (nature) player
-  virtual GamePlayer GetChance() const = 0;
+  virtual GamePlayerRep *GetChance() const = 0;
   /// Creates a new player in the game, with no moves
   virtual GamePlayer NewPlayer() = 0;
   //@}
@@ -816,11 +866,11 @@ public:
   /// @name Information sets
   //@{
   /// Returns the iset'th information set in the game (numbered globally)
-  virtual GameInfoset GetInfoset(int iset) const = 0;
+  virtual GameInfosetRep *GetInfoset(int iset) const = 0;
   /// Returns an array with the number of information sets per personal player
   virtual Array<int> NumInfosets() const = 0;
   /// Returns the act'th action in the game (numbered globally)
-  virtual GameAction GetAction(int act) const = 0;
+  virtual GameActionRep *GetAction(int act) const = 0;
   //@}
 
   /// @name Outcomes
@@ -828,7 +878,7 @@ public:
   /// Returns the number of outcomes defined in the game
   virtual int NumOutcomes() const = 0;
   /// Returns the index'th outcome defined in the game
-  virtual GameOutcome GetOutcome(int index) const = 0;
+  virtual GameOutcomeRep *GetOutcome(int index) const = 0;
   /// Creates a new outcome in the game
   virtual GameOutcome NewOutcome() = 0;
   /// Deletes the specified outcome from the game
@@ -865,6 +915,12 @@ Game NewTable(const Array<int> &p_dim, bool p_sparseOutcomes = false);
 // all classes to be defined.
 
 inline Game GameOutcomeRep::GetGame() const { return m_game; }
+inline void GameOutcomeRep::SetPayoff(int pl, const Number &p_value)
+{
+  if (m_game->IsFrozen()) throw FrozenGameException();
+  m_payoffs[pl] = p_value;
+  m_game->ClearPayoffCache();
+}
 inline const Number &GameOutcomeRep::GetPayoff(const GamePlayer &p_player) const
 {
   if (p_player->GetGame() != GetGame()) {
@@ -877,15 +933,17 @@ inline void GameOutcomeRep::SetPayoff(const GamePlayer &p_player, const Number &
   if (p_player->GetGame() != GetGame()) {
     throw MismatchException();
   }
+  if (m_game->IsFrozen()) throw FrozenGameException();
   m_payoffs[p_player->GetNumber()] = p_value;
+  m_game->ClearPayoffCache();
 }
 
-inline GamePlayer GameStrategyRep::GetPlayer() const { return m_player; }
+inline GamePlayerRep *GameStrategyRep::GetPlayer() const { return m_player; }
 
 inline Game GamePlayerRep::GetGame() const { return m_game; }
 inline int GamePlayerRep::NumStrategies() const 
 { m_game->BuildComputedValues(); return m_strategies.size(); }
-inline GameStrategy GamePlayerRep::GetStrategy(int st) const 
+inline GameStrategyRep *GamePlayerRep::GetStrategy(int st) const 
 { m_game->BuildComputedValues(); return m_strategies[st]; }
 inline const GameStrategyArray &GamePlayerRep::Strategies() const
 { m_game->BuildComputedValues(); return m_strategies; }
@@ -902,8 +960,12 @@ template<> inline std::string PureBehaviorProfile::GetPayoff(int pl) const
 //=======================================================================
 
 
-/// Reads a game in .efg or .nfg format from the input stream
+/// Reads a game in .efg, .nfg, or binary format from the input stream
 Game ReadGame(std::istream &);
+/// Reads a game from the named file.  A file in binary format is mapped
+/// into memory, where this is supported, and the game is built directly
+/// from the mapped data.
+Game ReadGame(const std::string &p_filename);
 
 } // end namespace gambit
 
@@ -119,7 +119,7 @@ Array<int> GameAggRep::NumStrategies() const
   return ns;
 }
 
-GameStrategy GameAggRep::GetStrategy(int p_index) const
+GameStrategyRep *GameAggRep::GetStrategy(int p_index) const
 {
   for (int pl = 1; pl <= aggPtr->getNumPlayers(); pl++) {
     if (m_players[pl]->NumStrategies() >= p_index) {
@@ -60,7 +60,7 @@ public:
   /// The number of strategies for each player
   Array<int> NumStrategies() const override;
   /// Gets the i'th strategy in the game, numbered globally
-  GameStrategy GetStrategy(int p_index) const override
+  GameStrategyRep *GetStrategy(int p_index) const override
   { throw UndefinedException(); }
   /// Returns the number of strategy contingencies in the game
   int NumStrategyContingencies() const override
@@ -83,9 +83,9 @@ public:
   /// Returns the number of players in the game
   int NumPlayers() const override { return m_players.size(); }
   /// Returns the pl'th player in the game
-  GamePlayer GetPlayer(int pl) const override { return m_players[pl]; }
+  GamePlayerRep *GetPlayer(int pl) const override { return m_players[pl]; }
   /// Returns the chance (nature) player
-  GamePlayer GetChance() const override
+  GamePlayerRep *GetChance() const override
   { throw UndefinedException(); }
   /// Creates a new player in the game, with no moves
   GamePlayer NewPlayer() override
@@ -95,13 +95,13 @@ public:
   /// @name Information sets
   //@{
   /// Returns the iset'th information set in the game (numbered globally)
-  GameInfoset GetInfoset(int iset) const override
+  GameInfosetRep *GetInfoset(int iset) const override
   { throw UndefinedException(); }
   /// Returns an array with the number of information sets per personal player
   Array<int> NumInfosets() const override
   { throw UndefinedException(); }
   /// Returns the act'th action in the game (numbered globally)
-  GameAction GetAction(int act) const override
+  GameActionRep *GetAction(int act) const override
   { throw UndefinedException(); }
   //@}
 
@@ -111,7 +111,7 @@ public:
   /// Returns the number of outcomes defined in the game
   int NumOutcomes() const override   { throw UndefinedException(); }
   /// Returns the index'th outcome defined in the game
-  GameOutcome GetOutcome(int index) const override
+  GameOutcomeRep *GetOutcome(int index) const override
   { throw UndefinedException(); }
   /// Creates a new outcome in the game
   GameOutcome NewOutcome() override  { throw UndefinedException(); }
@@ -63,7 +63,7 @@ public:
   /// The number of strategies for each player
   Array<int> NumStrategies() const override;
   /// Gets the i'th strategy in the game, numbered globally
-  GameStrategy GetStrategy(int p_index) const override;
+  GameStrategyRep *GetStrategy(int p_index) const override;
   /// Returns the number of strategy contingencies in the game
   int NumStrategyContingencies() const override;
   /// Returns the total number of strategies in the game
@@ -75,7 +75,7 @@ public:
   /// Returns the number of players in the game
   int NumPlayers() const override { return m_players.size(); }
   /// Returns the pl'th player in the game
-  GamePlayer GetPlayer(int pl) const override { return m_players[pl]; }
+  GamePlayerRep *GetPlayer(int pl) const override { return m_players[pl]; }
   //@}
 
   /// @name Outcomes
@@ -83,7 +83,7 @@ public:
   /// Returns the number of outcomes defined in the game
   int NumOutcomes() const override { return m_outcomes.size(); }
   /// Returns the index'th outcome defined in the game
-  GameOutcome GetOutcome(int index) const override { return m_outcomes[index]; }
+  GameOutcomeRep *GetOutcome(int index) const override { return m_outcomes[index]; }
   /// Creates a new outcome in the game
   GameOutcome NewOutcome() override;
 
@@ -86,31 +86,25 @@ GameOutcome TablePureStrategyProfileRep::GetOutcome() const
 
 void TablePureStrategyProfileRep::SetOutcome(GameOutcome p_outcome)
 {
-  dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index] = p_outcome; 
+  if (m_nfg->IsFrozen()) throw FrozenGameException();
+  auto &g = dynamic_cast<GameTableRep &>(*m_nfg);
+  g.m_results[m_index] = p_outcome;
+  g.ClearPayoffCache();
 }
 
 Rational TablePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index];
-  if (outcome) {
-    return static_cast<Rational>(outcome->GetPayoff(pl));
-  }
-  else {
-    return Rational(0);
-  }
+  auto &g = dynamic_cast<GameTableRep &>(*m_nfg);
+  return g.GetPayoffPlane<Rational>(pl)[m_index - 1];
 }
 
 Rational
 TablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
 {
   int player = p_strategy->GetPlayer()->GetNumber();
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index - m_profile[player]->m_offset + p_strategy->m_offset];
-  if (outcome) {
-    return static_cast<Rational>(outcome->GetPayoff(player));
-  }
-  else {
-    return Rational(0);
-  }
+  auto &g = dynamic_cast<GameTableRep &>(*m_nfg);
+  return g.GetPayoffPlane<Rational>(player)[m_index - m_profile[player]->m_offset + 
+                                            p_strategy->m_offset - 1];
 }
 
 PureStrategyProfile GameTableRep::NewPureStrategyProfile() const
@@ -167,10 +161,96 @@ GameTableRep::GameTableRep(const Array<int> &dim,
 
 Game GameTableRep::Copy() const
 {
-  std::ostringstream os;
-  WriteNfgFile(os);
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  Array<int> dim(m_players.size());
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    dim[pl] = m_players[pl]->m_strategies.size();
+  }
+  auto *copy = new GameTableRep(dim, true);
+  Game game(copy);
+  copy->m_title = m_title;
+  copy->m_comment = m_comment;
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    copy->m_players[pl]->m_label = m_players[pl]->m_label;
+    for (int st = 1; st <= dim[pl]; st++) {
+      copy->m_players[pl]->m_strategies[st]->m_label =
+        m_players[pl]->m_strategies[st]->m_label;
+    }
+  }
+
+  copy->m_outcomes = Array<GameOutcomeRep *>(m_outcomes.size());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    GameOutcomeRep *outcome = new GameOutcomeRep(copy, outc);
+    outcome->m_label = m_outcomes[outc]->m_label;
+    outcome->m_payoffs = m_outcomes[outc]->m_payoffs;
+    copy->m_outcomes[outc] = outcome;
+  }
+  for (int cont = 1; cont <= m_results.Length(); cont++) {
+    copy->m_results[cont] = (m_results[cont]) ?
+      copy->m_outcomes[m_results[cont]->m_number] : nullptr;
+  }
+  return game;
+}
+
+//------------------------------------------------------------------------
+//                     GameTableRep: Payoff planes
+//------------------------------------------------------------------------
+
+namespace {
+
+/// Flattens the payoffs of the outcomes in the table into one
+/// contiguous array per player.
+template <class T>
+void BuildPayoffPlanes(const Array<GameOutcomeRep *> &p_results, int p_numPlayers,
+                       std::vector<std::vector<T> > &p_planes)
+{
+  p_planes.assign(p_numPlayers, std::vector<T>(p_results.size(), T(0)));
+  for (int cont = 1; cont <= p_results.Length(); cont++) {
+    GameOutcomeRep *outcome = p_results[cont];
+    if (outcome) {
+      for (int pl = 1; pl <= p_numPlayers; pl++) {
+        p_planes[pl - 1][cont - 1] = static_cast<const T &>(outcome->GetPayoff(pl));
+      }
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+template<> 
+const std::vector<double> &GameTableRep::GetPayoffPlane(int pl) const
+{
+  if (m_doublePlanes.empty()) {
+    BuildPayoffPlanes(m_results, m_players.size(), m_doublePlanes);
+  }
+  return m_doublePlanes[pl - 1];
+}
+
+template<> 
+const std::vector<Rational> &GameTableRep::GetPayoffPlane(int pl) const
+{
+  if (m_rationalPlanes.empty()) {
+    BuildPayoffPlanes(m_results, m_players.size(), m_rationalPlanes);
+  }
+  return m_rationalPlanes[pl - 1];
+}
+
+void GameTableRep::ClearPayoffCache() const
+{
+  m_doublePlanes.clear();
+  m_rationalPlanes.clear();
+}
+
+Game GameTableRep::Freeze()
+{
+  if (!m_frozen) {
+    if (m_doublePlanes.empty()) {
+      BuildPayoffPlanes(m_results, m_players.size(), m_doublePlanes);
+    }
+    if (m_rationalPlanes.empty()) {
+      BuildPayoffPlanes(m_results, m_players.size(), m_rationalPlanes);
+    }
+  }
+  return GameExplicitRep::Freeze();
 }
 
 //------------------------------------------------------------------------
@@ -289,11 +369,14 @@ void GameTableRep::WriteNfgFile(std::ostream &p_file) const
 
 GamePlayer GameTableRep::NewPlayer()
 {
+  if (m_frozen) throw FrozenGameException();
   auto player = new GamePlayerRep(this, m_players.size() + 1, 1);
   m_players.push_back(player);
+  m_strides.push_back(m_results.Length());
   for (auto outcome : m_outcomes) {
     outcome->m_payoffs.push_back(Number());
   }
+  ClearPayoffCache();
   ClearComputedValues();
   return player;
 }
@@ -304,6 +387,7 @@ GamePlayer GameTableRep::NewPlayer()
 
 void GameTableRep::DeleteOutcome(const GameOutcome &p_outcome)
 {
+  if (m_frozen) throw FrozenGameException();
   for (int i = 1; i <= m_results.Length(); i++) {
     if (m_results[i] == p_outcome) {
       m_results[i] = 0;
@@ -313,6 +397,7 @@ void GameTableRep::DeleteOutcome(const GameOutcome &p_outcome)
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
     m_outcomes[outc]->m_number = outc;
   }
+  ClearPayoffCache();
   ClearComputedValues();
 }
 
@@ -378,14 +463,17 @@ void GameTableRep::RebuildTable()
   }
 
   m_results = newResults;
+  ClearPayoffCache();
 
   IndexStrategies();
 }
 
 void GameTableRep::IndexStrategies()
 {
+  m_strides = Array<long>(m_players.Length());
   long offset = 1L;
   for (auto player : m_players)  {
+    m_strides[player->m_number] = offset;
     int st = 1;
     for (auto strategy : player->m_strategies) {
       strategy->m_number = st;
@@ -23,6 +23,8 @@
 #ifndef GAMETABLE_H
 #define GAMETABLE_H
 
+#include <vector>
+
 #include "gameexpl.h"
 
 namespace Gambit {
@@ -34,8 +36,21 @@ class GameTableRep : public GameExplicitRep {
   friend class PureStrategyProfileRep;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
+  friend class BinaryGameWriter;
+  friend class BinaryGameReader;
 private:
   Array<GameOutcomeRep *> m_results;
+  /// The distance in the table between consecutive strategies of each
+  /// player; strategies of player 1 are adjacent
+  Array<long> m_strides;
+
+  /// @name Compiled payoff planes
+  //@{
+  /// Payoffs to each player, flattened in the same order as m_results
+  mutable std::vector<std::vector<double> > m_doublePlanes;
+  /// Exact payoffs to each player; built separately on first use
+  mutable std::vector<std::vector<Rational> > m_rationalPlanes;
+  //@}
 
   /// @name Private auxiliary functions
   //@{
@@ -43,6 +58,11 @@ private:
   void RebuildTable();
   //@}
 
+  /// @name Managing the representation
+  //@{
+  void ClearPayoffCache() const override;
+  //@}
+
 public:
   /// @name Lifecycle
   //@{
@@ -50,6 +70,7 @@ public:
   /// If p_sparseOutcomes = true, outcomes for all contingencies are left null
   explicit GameTableRep(const Array<int> &p_dim, bool p_sparseOutcomes = false);
   Game Copy() const override;
+  Game Freeze() override;
   //@}
 
   /// @name General data access
@@ -76,7 +97,7 @@ public:
   /// @name Players
   //@{
   /// Returns the chance (nature) player
-  GamePlayer GetChance() const override { throw UndefinedException(); }
+  GamePlayerRep *GetChance() const override { throw UndefinedException(); }
   /// Creates a new player in the game, with no moves
   GamePlayer NewPlayer() override;
   //@}
@@ -84,13 +105,13 @@ public:
   /// @name Information sets
   //@{
   /// Returns the iset'th information set in the game (numbered globally)
-  GameInfoset GetInfoset(int iset) const override 
+  GameInfosetRep *GetInfoset(int iset) const override 
   { throw UndefinedException(); }
   /// Returns an array with the number of information sets per personal player
   Array<int> NumInfosets() const override
   { throw UndefinedException(); }
   /// Returns the act'th action in the game (numbered globally)
-  GameAction GetAction(int act) const override
+  GameActionRep *GetAction(int act) const override
   { throw UndefinedException(); }
   //@}
 
@@ -102,6 +123,19 @@ public:
   int NumNodes() const override { throw UndefinedException(); }
   //@}
 
+  /// @name Payoff planes
+  //@{
+  /// \brief Returns the payoffs to player pl for every contingency.
+  ///
+  /// The plane is a contiguous array in which the payoff for the
+  /// contingency with table index i (the sum of the strategy offsets,
+  /// plus one) is stored at position i - 1.  Contingencies with no
+  /// outcome have payoff zero.  The plane is built on first use and
+  /// discarded whenever an outcome or a payoff in the table changes,
+  /// so the reference is only valid until the game is next modified.
+  template <class T> const std::vector<T> &GetPayoffPlane(int pl) const;
+  //@}
+
   /// @name Outcomes
   //@{
   /// Deletes the specified outcome from the game
@@ -126,6 +160,9 @@ public:
 
 };
 
+template<> const std::vector<double> &GameTableRep::GetPayoffPlane(int pl) const;
+template<> const std::vector<Rational> &GameTableRep::GetPayoffPlane(int pl) const;
+
 }
 
 
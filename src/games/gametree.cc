@@ -20,8 +20,10 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
+#include <unordered_map>
 
 #include "gambit.h"
 #include "gametree.h"
@@ -49,6 +51,7 @@ bool GameTreeActionRep::Precedes(const GameNode &n) const
 
 void GameTreeActionRep::DeleteAction()
 {
+  if (m_infoset->m_efg->IsFrozen()) throw FrozenGameException();
   if (m_infoset->NumActions() == 1) throw UndefinedException();
 
   int where;
@@ -70,7 +73,7 @@ void GameTreeActionRep::DeleteAction()
   m_infoset->m_efg->Canonicalize();
 }
 
-GameInfoset GameTreeActionRep::GetInfoset() const { return m_infoset; }
+GameInfosetRep *GameTreeActionRep::GetInfoset() const { return m_infoset; }
 
 //========================================================================
 //                       class GameTreeInfosetRep
@@ -107,6 +110,7 @@ Game GameTreeInfosetRep::GetGame() const { return m_efg; }
 
 void GameTreeInfosetRep::SetPlayer(GamePlayer p_player)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
   if (m_player->IsChance() || p_player->IsChance()) throw UndefinedException();
   if (m_player == p_player) return;
@@ -135,6 +139,7 @@ bool GameTreeInfosetRep::Precedes(GameNode p_node) const
 
 GameAction GameTreeInfosetRep::InsertAction(GameAction p_action /* =0 */)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_action && p_action->GetInfoset() != this) throw MismatchException();
   
   int where = m_actions.Length() + 1;
@@ -188,6 +193,7 @@ void GameTreeInfosetRep::RemoveMember(GameTreeNodeRep *p_node)
 
 void GameTreeInfosetRep::Reveal(GamePlayer p_player)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   for (int act = 1; act <= m_actions.Length(); act++) {
     GameActionRep *action = m_actions[act];
     for (int iset = 1; iset <= p_player->m_infosets.Length(); iset++) {
@@ -219,7 +225,7 @@ void GameTreeInfosetRep::Reveal(GamePlayer p_player)
 GameNode GameTreeInfosetRep::GetMember(int p_index) const 
 { return m_members[p_index]; }
 
-GamePlayer GameTreeInfosetRep::GetPlayer() const { return m_player; }
+GamePlayerRep *GameTreeInfosetRep::GetPlayer() const { return m_player; }
 
 bool GameTreeInfosetRep::IsChanceInfoset() const
 { return m_player->IsChance(); }
@@ -268,7 +274,7 @@ GameAction GameTreeNodeRep::GetPriorAction() const
   
   GameTreeInfosetRep *infoset = m_parent->infoset;
   for (int i = 1; i <= infoset->NumActions(); i++) {
-    if (GameNode(const_cast<GameTreeNodeRep *>(this)) == GetParent()->GetChild(i)) {
+    if (m_parent->children[i] == this) {
       return infoset->GetAction(i);
     }
   }
@@ -286,6 +292,7 @@ void GameTreeNodeRep::DeleteOutcome(GameOutcomeRep *outc)
 
 void GameTreeNodeRep::SetOutcome(const GameOutcome &p_outcome)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_outcome != outcome) {
     outcome = p_outcome;
     m_efg->ClearComputedValues();
@@ -312,7 +319,7 @@ bool GameTreeNodeRep::IsSubgameRoot() const
     GamePlayerRep *player = m_efg->GetPlayer(pl);
     
     for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      GameTreeInfosetRep *infoset = dynamic_cast<GameTreeInfosetRep *>(player->GetInfoset(iset).operator->());
+      GameTreeInfosetRep *infoset = dynamic_cast<GameTreeInfosetRep *>(player->GetInfoset(iset));
 
       bool precedes = infoset->GetMember(1)->IsSuccessorOf(const_cast<GameTreeNodeRep *>(this));
 
@@ -329,6 +336,7 @@ bool GameTreeNodeRep::IsSubgameRoot() const
 
 void GameTreeNodeRep::DeleteParent()
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (!m_parent) return;
   GameTreeNodeRep *oldParent = m_parent;
 
@@ -349,6 +357,7 @@ void GameTreeNodeRep::DeleteParent()
 
 void GameTreeNodeRep::DeleteTree()
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   while (!children.empty()) {
     children.front()->DeleteTree();
     children.front()->Invalidate();
@@ -386,6 +395,7 @@ void GameTreeNodeRep::CopySubtree(GameTreeNodeRep *src, GameTreeNodeRep *stop)
 
 void GameTreeNodeRep::CopyTree(GameNode p_src)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_src->GetGame() != m_efg) throw MismatchException();
   if (p_src == this || !children.empty()) return;
 
@@ -404,6 +414,7 @@ void GameTreeNodeRep::CopyTree(GameNode p_src)
 
 void GameTreeNodeRep::MoveTree(GameNode p_src)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_src->GetGame() != m_efg) throw MismatchException();
   if (p_src == this || !children.empty() || IsSuccessorOf(p_src)) {
     return;
@@ -434,14 +445,12 @@ void GameTreeNodeRep::MoveTree(GameNode p_src)
 
 Game GameTreeNodeRep::CopySubgame() const
 {
-  std::ostringstream os;
-  m_efg->WriteEfgFile(os, const_cast<GameTreeNodeRep *>(this));
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  return m_efg->CopySubtreeGame(this);
 }
 
 void GameTreeNodeRep::SetInfoset(GameInfoset p_infoset)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_infoset->GetGame() != m_efg) throw MismatchException();
   if (!infoset || infoset == p_infoset) return;
   if (p_infoset->NumActions() != children.Length()) 
@@ -457,6 +466,7 @@ void GameTreeNodeRep::SetInfoset(GameInfoset p_infoset)
 
 GameInfoset GameTreeNodeRep::LeaveInfoset()
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (!infoset) return nullptr;
 
   GameTreeInfosetRep *oldInfoset = infoset;
@@ -478,6 +488,7 @@ GameInfoset GameTreeNodeRep::LeaveInfoset()
 
 GameInfoset GameTreeNodeRep::AppendMove(GamePlayer p_player, int p_actions)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_actions <= 0 || !children.empty()) throw UndefinedException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
 
@@ -488,6 +499,7 @@ GameInfoset GameTreeNodeRep::AppendMove(GamePlayer p_player, int p_actions)
 
 GameInfoset GameTreeNodeRep::AppendMove(GameInfoset p_infoset)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (!children.empty()) throw UndefinedException();
   if (p_infoset->GetGame() != m_efg) throw MismatchException();
   
@@ -504,6 +516,7 @@ GameInfoset GameTreeNodeRep::AppendMove(GameInfoset p_infoset)
   
 GameInfoset GameTreeNodeRep::InsertMove(GamePlayer p_player, int p_actions)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_actions <= 0) throw UndefinedException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
 
@@ -514,6 +527,7 @@ GameInfoset GameTreeNodeRep::InsertMove(GamePlayer p_player, int p_actions)
 
 GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 {
+  if (m_efg->IsFrozen()) throw FrozenGameException();
   if (p_infoset->GetGame() != m_efg) throw MismatchException();
 
   auto *newNode = new GameTreeNodeRep(m_efg, m_parent);
@@ -561,12 +575,96 @@ GameTreeRep::~GameTreeRep()
   m_chance->Invalidate();
 }
 
+Game GameTreeRep::Freeze()
+{
+  if (!m_frozen) {
+    // Build the representation first, as canonicalization discards the layout
+    BuildComputedValues();
+    GetLayout();
+  }
+  return GameExplicitRep::Freeze();
+}
+
 Game GameTreeRep::Copy() const
 {
-  std::ostringstream os;
-  WriteEfgFile(os);
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  return CopySubtreeGame(m_root);
+}
+
+//
+// Builds a new game whose tree is a copy of the subtree rooted at p_root.
+// As when the game is written to a file, only the information sets and
+// outcomes which appear in the subtree are copied, numbered in order of
+// appearance.  Because the copy is built in preorder, its nodes are
+// numbered, its information sets' members listed and its information
+// sets ordered just as Canonicalize() would leave them, so the (quadratic)
+// canonicalization pass is not needed.  The source game is only read,
+// never modified.
+//
+Game GameTreeRep::CopySubtreeGame(const GameTreeNodeRep *p_root) const
+{
+  auto *copy = new GameTreeRep();
+  Game game(copy);
+  copy->m_title = m_title;
+  copy->m_comment = m_comment;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    copy->m_players.push_back(new GamePlayerRep(copy, pl));
+    copy->m_players[pl]->m_label = m_players[pl]->m_label;
+  }
+
+  std::unordered_map<const GameTreeInfosetRep *, GameTreeInfosetRep *> infosets;
+  std::unordered_map<const GameOutcomeRep *, GameOutcomeRep *> outcomes;
+  std::vector<std::pair<const GameTreeNodeRep *, GameTreeNodeRep *> >
+    stack(1, std::make_pair(p_root, copy->m_root));
+  int nodeIndex = 1;
+  while (!stack.empty()) {
+    const GameTreeNodeRep *src = stack.back().first;
+    GameTreeNodeRep *node = stack.back().second;
+    stack.pop_back();
+    node->number = nodeIndex++;
+    node->m_label = src->m_label;
+
+    if (src->outcome) {
+      auto entry = outcomes.emplace(src->outcome, nullptr);
+      if (entry.second) {
+        auto *outcome = new GameOutcomeRep(copy, copy->m_outcomes.size() + 1);
+        outcome->m_label = src->outcome->m_label;
+        outcome->m_payoffs = src->outcome->m_payoffs;
+        copy->m_outcomes.push_back(outcome);
+        entry.first->second = outcome;
+      }
+      node->outcome = entry.first->second;
+    }
+
+    if (src->children.empty()) continue;
+
+    auto entry = infosets.emplace(src->infoset, nullptr);
+    if (entry.second) {
+      const GameTreeInfosetRep *infoset = src->infoset;
+      GamePlayerRep *player = (infoset->m_player->IsChance()) ?
+	copy->m_chance : copy->m_players[infoset->m_player->m_number];
+      auto *newInfoset = new GameTreeInfosetRep(copy,
+						player->m_infosets.size() + 1,
+						player, infoset->m_actions.size());
+      newInfoset->m_label = infoset->m_label;
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	newInfoset->m_actions[act]->m_label = infoset->m_actions[act]->m_label;
+      }
+      if (player->IsChance()) {
+	newInfoset->m_probs = infoset->m_probs;
+      }
+      entry.first->second = newInfoset;
+    }
+    node->infoset = entry.first->second;
+    node->infoset->AddMember(node);
+    node->children = Array<GameTreeNodeRep *>(src->children.size());
+    for (int i = 1; i <= src->children.Length(); i++) {
+      node->children[i] = new GameTreeNodeRep(copy, node);
+    }
+    for (int i = src->children.Length(); i >= 1; i--) {
+      stack.push_back(std::make_pair(src->children[i], node->children[i]));
+    }
+  }
+  return game;
 }
 
 Game NewTree()  { return new GameTreeRep(); }
@@ -682,6 +780,7 @@ void GameTreeRep::NumberNodes(GameTreeNodeRep *n, int &index)
 
 void GameTreeRep::Canonicalize()
 {
+  m_layout.reset();
   if (!m_doCanon)  return;
   int nodeindex = 1;
   NumberNodes(m_root, nodeindex);
@@ -738,9 +837,77 @@ void GameTreeRep::ClearComputedValues() const
     }
   }
 
+  m_outcomeNodes.clear();
+  m_outcomeProbs.clear();
+  m_strategyReach.clear();
+  m_layout.reset();
   m_computedValues = false;
 }
 
+namespace {
+
+int CountOutcomeNodes(const GameNode &p_node)
+{
+  int count = (p_node->GetOutcome()) ? 1 : 0;
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    count += CountOutcomeNodes(p_node->GetChild(i));
+  }
+  return count;
+}
+
+}  // end anonymous namespace
+
+//
+// Walks the subtree rooted at p_node, which is reached by chance with
+// probability p_prob.  On entry, p_alive[pl] lists the strategies of
+// player pl which choose the path to p_node at each of pl's information
+// sets along it.  Each node with an outcome is appended to the tables,
+// and marked as reached by each strategy alive at it.
+//
+void GameTreeRep::BuildReach(GameTreeNodeRep *p_node, const Rational &p_prob,
+			     Array<Array<GameStrategyRep *> > &p_alive)
+{
+  if (p_node->outcome) {
+    int index = m_outcomeNodes.size();
+    m_outcomeNodes.push_back(p_node);
+    m_outcomeProbs.push_back(p_prob);
+    for (const auto &alive : p_alive) {
+      for (auto strategy : alive) {
+	m_strategyReach[strategy->m_id][index / 64] |= uint64_t(1) << (index % 64);
+      }
+    }
+  }
+
+  if (p_node->IsTerminal()) return;
+
+  GameTreeInfosetRep *infoset = p_node->infoset;
+  if (infoset->IsChanceInfoset()) {
+    for (int i = 1; i <= p_node->children.Length(); i++) {
+      BuildReach(p_node->children[i],
+		 p_prob * static_cast<Rational>(infoset->GetActionProb(i)),
+		 p_alive);
+    }
+    return;
+  }
+
+  int pl = infoset->GetPlayer()->GetNumber();
+  int iset = infoset->GetNumber();
+  Array<GameStrategyRep *> alive(std::move(p_alive[pl]));
+  for (int i = 1; i <= p_node->children.Length(); i++) {
+    // As in PureBehaviorProfile, a strategy which does not specify an
+    // action at the information set is taken to choose the first
+    p_alive[pl] = Array<GameStrategyRep *>();
+    for (auto strategy : alive) {
+      int act = strategy->m_behav[iset];
+      if (((act) ? act : 1) == i) {
+	p_alive[pl].push_back(strategy);
+      }
+    }
+    BuildReach(p_node->children[i], p_prob, p_alive);
+  }
+  p_alive[pl] = std::move(alive);
+}
+
 void GameTreeRep::BuildComputedValues()
 {
   if (m_computedValues) return;
@@ -756,6 +923,20 @@ void GameTreeRep::BuildComputedValues()
 	 m_players[pl]->m_strategies[st++]->m_id = id++);
   }
 
+  int words = (CountOutcomeNodes(m_root) + 63) / 64;
+  Array<Array<GameStrategyRep *> > alive(m_players.Length());
+  int numStrategies = 0;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    for (auto strategy : m_players[pl]->m_strategies) {
+      alive[pl].push_back(strategy);
+    }
+    numStrategies += m_players[pl]->m_strategies.Length();
+  }
+  m_strategyReach.assign(numStrategies + 1, std::vector<uint64_t>(words, 0));
+  m_outcomeNodes.clear();
+  m_outcomeProbs.clear();
+  BuildReach(m_root, Rational(1), alive);
+
   m_computedValues = true;
 }
 
@@ -939,6 +1120,7 @@ int GameTreeRep::BehavProfileLength() const
 
 GamePlayer GameTreeRep::NewPlayer()
 {
+  if (m_frozen) throw FrozenGameException();
   GamePlayerRep *player = nullptr;
   player = new GamePlayerRep(this, m_players.size() + 1);
   m_players.push_back(player);
@@ -953,7 +1135,7 @@ GamePlayer GameTreeRep::NewPlayer()
 //                   GameTreeRep: Information sets
 //------------------------------------------------------------------------
 
-GameInfoset GameTreeRep::GetInfoset(int p_index) const
+GameInfosetRep *GameTreeRep::GetInfoset(int p_index) const
 {
   int index = 1;
   for (auto player: m_players) {
@@ -975,7 +1157,7 @@ Array<int> GameTreeRep::NumInfosets() const
   return foo;
 }
 
-GameAction GameTreeRep::GetAction(int p_index) const
+GameActionRep *GameTreeRep::GetAction(int p_index) const
 {
   int index = 1;
   for (auto player: m_players) {
@@ -997,6 +1179,7 @@ GameAction GameTreeRep::GetAction(int p_index) const
 
 void GameTreeRep::DeleteOutcome(const GameOutcome &p_outcome)
 {
+  if (m_frozen) throw FrozenGameException();
   m_root->DeleteOutcome(p_outcome);
   m_outcomes.Remove(m_outcomes.Find(p_outcome))->Invalidate();
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
@@ -1025,6 +1208,78 @@ int GameTreeRep::NumNodes() const
   return CountNodes(m_root);
 }
 
+const GameTreeLayout &GameTreeRep::GetLayout() const
+{
+  if (m_layout) {
+    return *m_layout;
+  }
+  auto layout = std::unique_ptr<GameTreeLayout>(new GameTreeLayout);
+
+  std::unordered_map<const GameTreeInfosetRep *, int> index;
+  layout->m_firstAction.push_back(0);
+  for (int pl = 1; pl <= m_players.Length() + 1; pl++) {
+    GamePlayerRep *player = (pl <= m_players.Length()) ? m_players[pl] : m_chance;
+    for (auto infoset : player->m_infosets) {
+      index[infoset] = layout->m_infosets.size();
+      layout->m_infosets.push_back(infoset);
+      layout->m_player.push_back(player->GetNumber());
+      layout->m_firstAction.push_back(layout->m_firstAction.back() +
+                                      infoset->m_actions.Length());
+    }
+    if (pl == m_players.Length()) {
+      layout->m_numPersonal = layout->m_infosets.size();
+    }
+  }
+
+  // Children are pushed in reverse, so the stack yields nodes in preorder
+  std::unordered_map<const GameTreeNodeRep *, int> positions;
+  std::vector<std::pair<GameTreeNodeRep *, int> > stack(1, std::make_pair(m_root, -1));
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back().first;
+    int parent = stack.back().second;
+    stack.pop_back();
+    int position = layout->m_nodes.size();
+    positions[node] = position;
+    layout->m_nodes.push_back(node);
+    layout->m_number.push_back(node->number);
+    layout->m_parent.push_back(parent);
+    layout->m_action.push_back(0);
+    layout->m_infoset.push_back((node->infoset) ? index[node->infoset] : -1);
+    layout->m_outcome.push_back(node->outcome);
+    for (int i = node->children.Length(); i >= 1; i--) {
+      stack.emplace_back(node->children[i], position);
+    }
+  }
+
+  int numNodes = layout->m_nodes.size();
+  std::vector<int> numChildren(numNodes, 0);
+  for (int i = 1; i < numNodes; i++) {
+    numChildren[layout->m_parent[i]]++;
+  }
+  layout->m_firstChild.assign(numNodes + 1, 0);
+  for (int i = 0; i < numNodes; i++) {
+    layout->m_firstChild[i + 1] = layout->m_firstChild[i] + numChildren[i];
+  }
+  layout->m_children.resize(layout->m_firstChild[numNodes]);
+  std::fill(numChildren.begin(), numChildren.end(), 0);
+  for (int i = 1; i < numNodes; i++) {
+    int parent = layout->m_parent[i];
+    layout->m_action[i] = ++numChildren[parent];
+    layout->m_children[layout->m_firstChild[parent] + numChildren[parent] - 1] = i;
+  }
+
+  layout->m_firstMember.push_back(0);
+  for (auto infoset : layout->m_infosets) {
+    for (auto member : infoset->m_members) {
+      layout->m_members.push_back(positions[member]);
+    }
+    layout->m_firstMember.push_back(layout->m_members.size());
+  }
+
+  m_layout = std::move(layout);
+  return *m_layout;
+}
+
 
 //------------------------------------------------------------------------
 //                       GameTreeRep: Modification
@@ -1032,6 +1287,7 @@ int GameTreeRep::NumNodes() const
 
 Game GameTreeRep::SetChanceProbs(const GameInfoset &p_infoset, const Array<Number> &p_probs)
 {
+  if (m_frozen) throw FrozenGameException();
   if (p_infoset->GetGame() != this) {
     throw MismatchException();
   }
@@ -1124,6 +1380,57 @@ MixedStrategyProfile<Rational> GameTreeRep::NewMixedStrategyProfile(const Ration
 }
 
 
+//------------------------------------------------------------------------
+//             GameTreeRep: Payoffs of pure strategy profiles
+//------------------------------------------------------------------------
+
+//
+// The nodes with outcomes reached under a pure strategy profile are
+// those reached by the strategy of every player, so the payoff is
+// obtained by intersecting the strategies' bitsets, and summing the
+// outcomes at the nodes which remain, weighted by the chance moves.
+// If p_deviation is not null, it is played in place of the strategy
+// of its player in p_profile.  The tables are rebuilt if the tree has
+// changed since they were computed; the strategies of the profile are
+// then no longer valid, and an InvalidObjectException is thrown.
+//
+Rational GameTreeRep::GetPurePayoff(const Array<GameStrategy> &p_profile,
+				    int pl,
+				    const GameStrategyRep *p_deviation) const
+{
+  const_cast<GameTreeRep *>(this)->BuildComputedValues();
+  if (p_deviation && !p_deviation->IsValid()) {
+    throw InvalidObjectException();
+  }
+
+  Array<const uint64_t *> reach(p_profile.Length());
+  for (int i = 1; i <= p_profile.Length(); i++) {
+    const GameStrategyRep *strategy = p_profile[i];
+    if (!strategy->IsValid()) {
+      throw InvalidObjectException();
+    }
+    if (p_deviation && p_deviation->m_player == strategy->m_player) {
+      strategy = p_deviation;
+    }
+    reach[i] = m_strategyReach[strategy->m_id].data();
+  }
+
+  Rational payoff(0);
+  for (size_t w = 0; w < m_strategyReach[0].size(); w++) {
+    uint64_t bits = ~uint64_t(0);
+    for (int i = 1; i <= reach.Length() && bits; i++) {
+      bits &= reach[i][w];
+    }
+    while (bits) {
+      int index = 64 * w + __builtin_ctzll(bits);
+      bits &= bits - 1;
+      payoff += (m_outcomeProbs[index] *
+		 static_cast<Rational>(m_outcomeNodes[index]->outcome->GetPayoff(pl)));
+    }
+  }
+  return payoff;
+}
+
 //========================================================================
 //                  class TreePureStrategyProfileRep
 //========================================================================
@@ -1169,25 +1476,15 @@ void TreePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 
 Rational TreePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  PureBehaviorProfile behav(m_nfg);
-  for (int i = 1; i <= m_nfg->NumPlayers(); i++) {
-    GamePlayer player = m_nfg->GetPlayer(i);
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      int act = m_profile[i]->m_behav[iset];
-      if (act) {
-	behav.SetAction(player->GetInfoset(iset)->GetAction(act));
-      }
-    }
-  }
-  return behav.GetPayoff<Rational>(pl);
+  return static_cast<GameTreeRep &>(*m_nfg).GetPurePayoff(m_profile, pl, nullptr);
 }
 
 Rational
 TreePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
 {
-  PureStrategyProfile copy(Copy());
-  copy->SetStrategy(p_strategy);
-  return copy->GetPayoff(p_strategy->GetPlayer()->GetNumber());
+  return static_cast<GameTreeRep &>(*m_nfg).GetPurePayoff(m_profile,
+							 p_strategy->GetPlayer()->GetNumber(),
+							 p_strategy);
 }
 
 
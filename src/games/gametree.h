@@ -23,6 +23,10 @@
 #ifndef GAMETREE_H
 #define GAMETREE_H
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "gameexpl.h"
 
 namespace Gambit {
@@ -46,7 +50,7 @@ private:
 
 public:
   int GetNumber() const override { return m_number; }
-  GameInfoset GetInfoset() const override;
+  GameInfosetRep *GetInfoset() const override;
 
   const std::string &GetLabel() const override { return m_label; }
   void SetLabel(const std::string &p_label) override { m_label = p_label; }
@@ -88,7 +92,7 @@ public:
   Game GetGame() const override;
   int GetNumber() const override { return m_number; }
   
-  GamePlayer GetPlayer() const override;
+  GamePlayerRep *GetPlayer() const override;
   void SetPlayer(GamePlayer p) override;
 
   bool IsChanceInfoset() const override;
@@ -103,7 +107,7 @@ public:
   /// Returns the number of actions available at the information set
   int NumActions() const override { return m_actions.size(); }
   /// Returns the p_index'th action at the information set
-  GameAction GetAction(int p_index) const override { return m_actions[p_index]; }
+  GameActionRep *GetAction(int p_index) const override { return m_actions[p_index]; }
   /// Returns a forward iterator over the available actions
   //virtual GameActionIterator Actions(void) const 
   //  { return GameActionIterator(m_actions); }
@@ -190,20 +194,97 @@ public:
 };
 
 
+///
+/// The structure of a game tree, copied into flat arrays so that it can be
+/// traversed with loops rather than by following pointers.  Nodes are
+/// indexed by their position in preorder, so the root is node 0 and each
+/// node comes after its parent and before its descendants.  Information
+/// sets are indexed consecutively over the personal players in order,
+/// and then chance; the actions of all information sets likewise share one
+/// flat index, so the actions of the personal players are numbered as in
+/// a behavior profile.  Payoffs and chance probabilities are not copied,
+/// but are read through the outcome and information set pointers.
+///
+struct GameTreeLayout {
+  /// @name Nodes
+  //@{
+  /// The node at each position
+  std::vector<GameTreeNodeRep *> m_nodes;
+  /// The number of each node
+  std::vector<int> m_number;
+  /// The position of the parent of each node (-1 for the root)
+  std::vector<int> m_parent;
+  /// The number of the action leading to each node (0 for the root)
+  std::vector<int> m_action;
+  /// The information set at each node (-1 for terminal nodes)
+  std::vector<int> m_infoset;
+  /// The outcome attached to each node, or null
+  std::vector<GameOutcomeRep *> m_outcome;
+  /// The children of node i, in order, are m_children[m_firstChild[i]]
+  /// up to but not including m_children[m_firstChild[i+1]]
+  std::vector<int> m_firstChild, m_children;
+  //@}
+
+  /// @name Information sets
+  //@{
+  /// The information set at each position
+  std::vector<GameTreeInfosetRep *> m_infosets;
+  /// The number of the player at each information set (0 for chance)
+  std::vector<int> m_player;
+  /// The number of information sets of the personal players
+  int m_numPersonal{0};
+  /// The actions of information set j have flat indices m_firstAction[j]
+  /// up to but not including m_firstAction[j+1]
+  std::vector<int> m_firstAction;
+  /// The members of information set j, in order, are
+  /// m_members[m_firstMember[j]] up to but not including
+  /// m_members[m_firstMember[j+1]]
+  std::vector<int> m_firstMember, m_members;
+  //@}
+
+  /// Returns the number of nodes
+  int NumNodes() const { return m_nodes.size(); }
+  /// Returns the total number of actions, including those of chance
+  int NumActions() const { return m_firstAction.back(); }
+};
+
 class GameTreeRep : public GameExplicitRep {
   friend class GameTreeNodeRep;
   friend class GameTreeInfosetRep;
   friend class GameTreeActionRep;
+  friend class TreePureStrategyProfileRep;
+  template <class T> friend class TreeMixedStrategyProfileRep;
 protected:
   mutable bool m_computedValues, m_doCanon;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
 
+  /// @name Tables for the payoffs of pure strategy profiles
+  //@{
+  /// The nodes which have outcomes
+  mutable std::vector<GameTreeNodeRep *> m_outcomeNodes;
+  /// The probability that chance moves reach each node in m_outcomeNodes
+  mutable std::vector<Rational> m_outcomeProbs;
+  /// For each strategy, indexed by its ID, the set of nodes in
+  /// m_outcomeNodes which are reached unless some other player deviates
+  /// from the path, as a bitset
+  mutable std::vector<std::vector<uint64_t> > m_strategyReach;
+  //@}
+
+  /// The flattened structure of the tree, built on first use
+  mutable std::unique_ptr<GameTreeLayout> m_layout;
+
   /// @name Private auxiliary functions
   //@{
   void NumberNodes(GameTreeNodeRep *, int &);
+  void BuildReach(GameTreeNodeRep *, const Rational &,
+                  Array<Array<GameStrategyRep *> > &);
+  Rational GetPurePayoff(const Array<GameStrategy> &, int pl,
+                         const GameStrategyRep *p_deviation) const;
   /// Normalize the probability distribution of actions at a chance node
   Game NormalizeChanceProbs(const GameInfoset &);
+  /// Build a new game from the subtree rooted at the node
+  Game CopySubtreeGame(const GameTreeNodeRep *) const;
   //@}
 
   /// @name Managing the representation
@@ -221,6 +302,7 @@ public:
   GameTreeRep();
   ~GameTreeRep() override;
   Game Copy() const override;
+  Game Freeze() override;
   //@}
 
   /// @name General data access
@@ -238,7 +320,7 @@ public:
   /// @name Players
   //@{
   /// Returns the chance (nature) player
-  GamePlayer GetChance() const override { return m_chance; } 
+  GamePlayerRep *GetChance() const override { return m_chance; } 
   /// Creates a new player in the game, with no moves
   GamePlayer NewPlayer() override;
   //@}
@@ -249,6 +331,10 @@ public:
   GameNode GetRoot() const override { return m_root; } 
   /// Returns the number of nodes in the game
   int NumNodes() const override;
+  /// Returns the structure of the tree in flat arrays.  The layout is
+  /// rebuilt after any change to the structure of the tree, which
+  /// invalidates references previously returned.
+  const GameTreeLayout &GetLayout() const;
   //@}
 
   void DeleteOutcome(const GameOutcome &) override;
@@ -273,11 +359,11 @@ public:
   /// @name Information sets
   //@{
   /// Returns the iset'th information set in the game (numbered globally)
-  GameInfoset GetInfoset(int iset) const override;
+  GameInfosetRep *GetInfoset(int iset) const override;
   /// Returns an array with the number of information sets per personal player
   Array<int> NumInfosets() const override;
   /// Returns the act'th action in the game (numbered globally)
-  GameAction GetAction(int act) const override;
+  GameActionRep *GetAction(int act) const override;
   //@}
 
   /// @name Modification
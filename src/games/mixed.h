@@ -24,11 +24,15 @@
 #define LIBGAMBIT_MIXED_H
 
 #include "core/vector.h"
+#include "core/matrix.h"
+#include "core/pvector.h"
 #include "games/gameagg.h"
 #include "games/gamebagg.h"
 
 namespace Gambit {
 
+class GameTreeRep;
+
 template <class T> class MixedStrategyProfileRep {
 public:
   Vector<T> m_probs;
@@ -52,12 +56,37 @@ public:
   virtual T GetPayoff(int pl) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const = 0;
+  virtual void GetPayoffDerivs(int pl, T &p_payoff, Vector<T> &p_deriv1,
+                               Matrix<T> &p_deriv2) const;
+  virtual Vector<T> GetStrategyValues(int pl) const;
+  PVector<T> GetStrategyValues() const;
 
   T GetRegret(const GameStrategy &) const;
 };
 
 template <class T> class TreeMixedStrategyProfileRep 
   : public MixedStrategyProfileRep<T> {
+private:
+  /// @name Private sequence form evaluation functions
+  //@{
+  /// Returns the game, with its reach tables rebuilt if the tree has
+  /// changed since they were computed
+  const GameTreeRep &GetTree() const;
+  /// Returns, for each player, the probability that the player's
+  /// strategies permit each node with an outcome to be reached
+  Array<std::vector<T> > GetRealizationWeights() const;
+  /// Returns the payoff to player pl at each node with an outcome,
+  /// weighted by the probability chance moves reach it
+  std::vector<T> GetNodeValues(int pl) const;
+  /// Returns the sum of the node values over the nodes reached by each
+  /// of the strategies, weighted by the realization weights of all
+  /// players other than those playing the strategies
+  T SumOverReached(const std::vector<T> &p_values,
+                   const Array<std::vector<T> > &p_weights,
+                   const GameStrategy &p_strategy1,
+                   const GameStrategy &p_strategy2 = nullptr) const;
+  //@}
+
 public:
   explicit TreeMixedStrategyProfileRep(const StrategySupportProfile &p_support)
     : MixedStrategyProfileRep<T>(p_support)
@@ -69,21 +98,36 @@ public:
   T GetPayoff(int pl) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const override;
+  void GetPayoffDerivs(int pl, T &p_payoff, Vector<T> &p_deriv1,
+                       Matrix<T> &p_deriv2) const override;
+  Vector<T> GetStrategyValues(int pl) const override;
 };
 
 template <class T> class TableMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
 private:
-  /// @name Private recursive payoff functions
+  /// The strategies of one player which enter a contraction of the
+  /// payoff table, with their offsets in the table and their weights
+  struct Axis {
+    long m_stride;
+    std::vector<long> m_offsets;
+    std::vector<T> m_weights;
+  };
+
+  /// @name Private payoff table contraction functions
   //@{
-  /// Recursive computation of payoff to player pl
-  T GetPayoff(int pl, int index, int i) const;
-  /// Recursive computation of payoff derivative
-  void GetPayoffDeriv(int pl, int const_pl, int cur_pl, long index,
-		      const T &prob, T &value) const;
-  /// Recursive computation of payoff second derivative
-  void GetPayoffDeriv(int pl, int const_pl1, int const_pl2, 
-		      int cur_pl, long index, const T &prob, T &value) const;
+  /// Returns the payoff plane for player pl in the underlying table
+  const std::vector<T> &GetPayoffPlane(int pl) const;
+  /// Returns the axis of each player, weighted by the profile.  Only
+  /// nonzero weights are kept, or only positive ones if p_positive is set
+  Array<Axis> GetAxes(bool p_positive) const;
+  /// Allocates a scratch buffer for each level of a contraction
+  static Array<std::vector<T> > GetWorkspace(const Array<Axis> &p_axes);
+  /// Contracts a block over players 1..k along the axis of player k
+  static void Contract(const T *p_block, const Axis &p_axis, T *p_result);
+  /// Contracts a block over players 1..k along the axes of all k players
+  static T ContractAll(const T *p_block, const Array<Axis> &p_axes, int k,
+                       Array<std::vector<T> > &p_work);
   //@}
 
 public:
@@ -96,10 +140,17 @@ public:
   T GetPayoff(int pl) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const override;
+  void GetPayoffDerivs(int pl, T &p_payoff, Vector<T> &p_deriv1,
+                       Matrix<T> &p_deriv2) const override;
+  Vector<T> GetStrategyValues(int pl) const override;
 };
 
 template <class T> class AggMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
+private:
+  /// Returns the profile as a vector over all actions of the AGG, with
+  /// zero for strategies outside the support
+  std::vector<T> GetActionProbs() const;
 
 public:
   explicit AggMixedStrategyProfileRep(const StrategySupportProfile &p_support)
@@ -113,10 +164,19 @@ public:
   T GetPayoff(int pl) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const override;
+  void GetPayoffDerivs(int pl, T &p_payoff, Vector<T> &p_deriv1,
+                       Matrix<T> &p_deriv2) const override;
+  Vector<T> GetStrategyValues(int pl) const override;
 };
 
 template <class T> class BagentMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
+private:
+  /// Returns the profile as a vector over all actions of all types of the
+  /// BAGG, with zero for strategies outside the support
+  std::vector<T> GetTypeActionProbs() const;
+  /// Returns the player and type of the BAGG that are agent pl
+  void GetPlayerType(int pl, int &p_player, int &p_type) const;
 
 public:
   explicit BagentMixedStrategyProfileRep(const StrategySupportProfile &p_support)
@@ -130,6 +190,9 @@ public:
   T GetPayoff(int pl) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &) const override;
   T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const override;
+  void GetPayoffDerivs(int pl, T &p_payoff, Vector<T> &p_deriv1,
+                       Matrix<T> &p_deriv2) const override;
+  Vector<T> GetStrategyValues(int pl) const override;
 };
 
 /// \brief A probability distribution over strategies in a game
@@ -251,10 +314,41 @@ public:
   T GetPayoffDeriv(int pl, const GameStrategy &s1, const GameStrategy &s2) const
   { return m_rep->GetPayoffDeriv(pl, s1, s2); }
 
+  /// \brief Computes the payoff to the player with all its derivatives
+  ///
+  /// Computes in one pass the payoff to player 'pl', its derivative with
+  /// respect to the probability of each strategy in the support, and its
+  /// second derivative with respect to each strategy of player 'pl' and
+  /// each strategy of another player.  Derivatives are indexed as the
+  /// probabilities in the profile, so p_deriv1 and p_deriv2 must have
+  /// MixedProfileLength() entries and rows and columns.  All other
+  /// entries of p_deriv2 are set to zero.
+  void GetPayoffDerivs(int pl, T &p_payoff, Vector<T> &p_deriv1,
+                       Matrix<T> &p_deriv2) const
+  { m_rep->GetPayoffDerivs(pl, p_payoff, p_deriv1, p_deriv2); }
+
   /// Computes the payoff to playing the pure strategy against the profile
   T GetPayoff(const GameStrategy &p_strategy) const
   { return GetPayoffDeriv(p_strategy->GetPlayer()->GetNumber(), p_strategy); }
 
+  /// \brief Computes the payoffs to playing each of the player's strategies
+  ///
+  /// Computes the payoff to playing each strategy of the player in the
+  /// support against the profile.  The values are indexed as the player's
+  /// strategies in the support, and are computed together, which is
+  /// considerably cheaper than calling GetPayoff() for each strategy.
+  Vector<T> GetStrategyValues(const GamePlayer &p_player) const
+  { return m_rep->GetStrategyValues(p_player->GetNumber()); }
+
+  /// \brief Computes the payoffs to playing each strategy in the support
+  ///
+  /// Computes the payoff to playing each strategy in the support against
+  /// the profile.  The values are indexed by player and by the index of
+  /// the strategy in the support, so that entries are laid out as the
+  /// probabilities in the profile.
+  PVector<T> GetStrategyValues() const
+  { return m_rep->GetStrategyValues(); }
+
   /// Computes the regret to playing the pure strategy compared to the payoff
   /// of the best response
   T GetRegret(const GameStrategy &p_strategy) const
@@ -60,9 +60,18 @@ public:
     : m_text(lexical_cast<std::string>(p_rational)), m_rational(p_rational),
       m_double(static_cast<double>(p_rational))
   { }
+  /// Construct a new number with text p_text, whose value is already
+  /// known to be p_rational
+  Number(const std::string &p_text, const Rational &p_rational)
+    : m_text(p_text), m_rational(p_rational),
+      m_double(static_cast<double>(p_rational))
+  { }
   ~Number() = default;
 
+  Number(const Number &) = default;
+  Number(Number &&) = default;
   Number &operator=(const Number &p_number) = default;
+  Number &operator=(Number &&) = default;
   Number &operator=(const std::string &p_text)
   {
     // We call lexical_cast<Rational>() first because it throws a ValueException
@@ -20,7 +20,12 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "gambit.h"
+#include "core/parallel.h"
 #include "solvers/linalg/vertenum.imp"
 #include "solvers/enummixed/enummixed.h"
 #include "clique.h"
@@ -30,6 +35,89 @@ namespace Nash {
 
 using namespace Gambit::linalg;
 
+namespace {
+
+//
+// The basic variables at the vertices of one of the two polytopes, as
+// bit strings for testing pairs of vertices for complementarity.  Bit
+// k-1 stands for player 1's k'th strategy and bit n1+k-1 for player 2's,
+// whether the basic variable is the probability of the strategy (at a
+// vertex of player 1's polytope for player 1's strategies) or the slack
+// of its payoff constraint (at a vertex of the opponent's polytope).
+// Two vertices are then complementary unless they share a bit, and where
+// they do, unless the product of the two values is zero.
+//
+template <class T> class VertexLabels {
+public:
+  /// p_ownStrategies is the player whose strategies are the positive keys
+  VertexLabels(const List<BFS<T> > &p_vertices, int p_ownStrategies, int n1, int n2);
+
+  const BFS<T> &GetBFS(int i) const { return *m_vertices[i - 1]; }
+
+  /// Returns true if vertex i and vertex j of p_other are complementary,
+  /// testing products of values with p_isZero
+  template <class Z> bool IsComplementary(int i, const VertexLabels<T> &p_other,
+                                          int j, Z p_isZero) const;
+
+private:
+  using Word = uint64_t;
+  static const int BITS = 64;
+
+  std::vector<const BFS<T> *> m_vertices;
+  int m_own, m_n1, m_words;
+  std::vector<Word> m_labels;
+
+  /// Returns the key of the variable with the bit
+  int Key(int p_bit) const
+  { return (p_bit < m_n1) ? ((m_own == 1) ? p_bit + 1 : -(p_bit + 1))
+                          : ((m_own == 2) ? p_bit - m_n1 + 1 : -(p_bit - m_n1 + 1)); }
+};
+
+template <class T>
+VertexLabels<T>::VertexLabels(const List<BFS<T> > &p_vertices,
+                              int p_ownStrategies, int n1, int n2)
+  : m_own(p_ownStrategies), m_n1(n1), m_words((n1 + n2 + BITS - 1) / BITS)
+{
+  for (const auto &vertex : p_vertices) {
+    m_vertices.push_back(&vertex);
+  }
+  m_labels.resize(m_vertices.size() * m_words, 0);
+  for (size_t i = 0; i < m_vertices.size(); i++) {
+    Word *labels = &m_labels[i * m_words];
+    for (int bit = 0; bit < n1 + n2; bit++) {
+      if (m_vertices[i]->count(Key(bit))) {
+        labels[bit / BITS] |= Word(1) << (bit % BITS);
+      }
+    }
+  }
+}
+
+template <class T> template <class Z>
+bool VertexLabels<T>::IsComplementary(int i, const VertexLabels<T> &p_other,
+                                      int j, Z p_isZero) const
+{
+  const Word *labels = &m_labels[(i - 1) * m_words];
+  const Word *other = &p_other.m_labels[(j - 1) * m_words];
+  Word shared = 0;
+  for (int w = 0; w < m_words; w++) {
+    shared |= labels[w] & other[w];
+  }
+  if (shared == 0) {
+    return true;
+  }
+  for (int bit = 0; bit < m_words * BITS; bit++) {
+    if ((labels[bit / BITS] & other[bit / BITS]) & (Word(1) << (bit % BITS))) {
+      if (!p_isZero((*m_vertices[i - 1])[Key(bit)] *
+                    (*p_other.m_vertices[j - 1])[p_other.Key(bit)])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // end anonymous namespace
+
 template <class T> List<List<MixedStrategyProfile<T> > > 
 EnumMixedStrategySolution<T>::GetCliques() const
 {
@@ -126,68 +214,82 @@ EnumMixedStrategySolver<T>::SolveDetailed(const Game &p_game) const
   solution->m_v1 = verts1.Length();
   solution->m_v2 = verts2.Length();
 
+  int n1 = p_game->GetPlayer(1)->Strategies().size();
+  int n2 = p_game->GetPlayer(2)->Strategies().size();
+  VertexLabels<T> labels2(verts2, 1, n1, n2), labels1(verts1, 2, n1, n2);
+
+  // Find the complementary pairs of vertices.  The rows of the scan are
+  // split into blocks which are scanned independently; within a block,
+  // columns are taken a tile at a time, so the labels of a tile are
+  // reused for every row of the block.
+  const int ROWS = 64, COLUMNS = 512;
+  int numBlocks = (solution->m_v2 - 1 + ROWS - 1) / ROWS;
+  std::vector<std::vector<std::pair<int, int> > > pairs(numBlocks);
+  ParallelFor(numBlocks, m_threads, [&](int block) {
+    int first = 2 + (block - 1) * ROWS;
+    int last = std::min(first + ROWS - 1, solution->m_v2);
+    auto &found = pairs[block - 1];
+    for (int tile = 2; tile <= solution->m_v1; tile += COLUMNS) {
+      int tileEnd = std::min(tile + COLUMNS - 1, solution->m_v1);
+      for (int i2 = first; i2 <= last; i2++) {
+        for (int i1 = tile; i1 <= tileEnd; i1++) {
+          // check if solution is nash 
+          // need only check complementarity, since it is feasible
+          if (labels2.IsComplementary(i2, labels1, i1, EqZero)) {
+            found.emplace_back(i2, i1);
+          }
+        }
+      }
+    }
+    std::sort(found.begin(), found.end());
+    return true;
+  });
+
   Array<int> vert1id(solution->m_v1);
   Array<int> vert2id(solution->m_v2);
   for (int i = 1; i <= vert1id.Length(); vert1id[i++] = 0);
   for (int i = 1; i <= vert2id.Length(); vert2id[i++] = 0);
 
-  int i = 0;
   int id1 = 0, id2 = 0;
 
-  for (int i2 = 2; i2 <= solution->m_v2; i2++) {
-    const BFS<T> &bfs1 = verts2[i2];
-    i++;
-    for (int i1 = 2; i1 <= solution->m_v1; i1++) {
-      const BFS<T> &bfs2 = verts1[i1];
-
-      // check if solution is nash 
-      // need only check complementarity, since it is feasible
-      bool nash = true;
-      for (size_t k = 1; nash && k <= p_game->GetPlayer(1)->Strategies().size(); k++) {
-        if (bfs1.count(k) && bfs2.count(-k)) {
-          nash = EqZero(bfs1[k] * bfs2[-k]);
+  for (const auto &block : pairs) {
+    for (const auto &pair : block) {
+      int i2 = pair.first, i1 = pair.second;
+      const BFS<T> &bfs1 = labels2.GetBFS(i2);
+      const BFS<T> &bfs2 = labels1.GetBFS(i1);
+
+      MixedStrategyProfile<T> eqm(p_game->NewMixedStrategyProfile(static_cast<T>(0)));
+      static_cast<Vector<T> &>(eqm) = static_cast<T>(0);
+      for (size_t k = 1; k <= p_game->GetPlayer(1)->Strategies().size(); k++) {
+        if (bfs1.count(k)) {
+          eqm[p_game->GetPlayer(1)->Strategies()[k]] = -bfs1[k];
         }
       }
-      for (size_t k = 1; nash && k <= p_game->GetPlayer(2)->Strategies().size(); k++) {
-        if (bfs2.count(k) && bfs1.count(-k)) {
-          nash = EqZero(bfs2[k] * bfs1[-k]);
+      for (size_t k = 1; k <= p_game->GetPlayer(2)->Strategies().size(); k++) {
+        if (bfs2.count(k)) {
+          eqm[p_game->GetPlayer(2)->Strategies()[k]] = -bfs2[k];
         }
       }
+      eqm = eqm.Normalize();
+      solution->m_extremeEquilibria.push_back(eqm);
+      this->m_onEquilibrium->Render(eqm);
 
-      if (nash) {
-        MixedStrategyProfile<T> eqm(p_game->NewMixedStrategyProfile(static_cast<T>(0)));
-        static_cast<Vector<T> &>(eqm) = static_cast<T>(0);
-        for (size_t k = 1; k <= p_game->GetPlayer(1)->Strategies().size(); k++) {
-          if (bfs1.count(k)) {
-            eqm[p_game->GetPlayer(1)->Strategies()[k]] = -bfs1[k];
-          }
-        }
-        for (size_t k = 1; k <= p_game->GetPlayer(2)->Strategies().size(); k++) {
-          if (bfs2.count(k)) {
-            eqm[p_game->GetPlayer(2)->Strategies()[k]] = -bfs2[k];
-          }
-        }
-        eqm = eqm.Normalize();
-        solution->m_extremeEquilibria.push_back(eqm);
-        this->m_onEquilibrium->Render(eqm);
-
-        // note: The keys give the mixed strategy associated with each node.
-        //       The keys should also keep track of the basis
-        //       As things stand now, two different bases could lead to
-        //       the same key... BAD!
-        if (vert1id[i1] == 0) {
-          id1++;
-          vert1id[i1] = id1;
-          solution->m_key2.push_back(eqm[p_game->GetPlayer(2)]);
-        }
-        if (vert2id[i2] == 0) {
-          id2++;
-          vert2id[i2] = id2;
-          solution->m_key1.push_back(eqm[p_game->GetPlayer(1)]);
-        }
-        solution->m_node1.push_back(vert2id[i2]);
-        solution->m_node2.push_back(vert1id[i1]);
+      // note: The keys give the mixed strategy associated with each node.
+      //       The keys should also keep track of the basis
+      //       As things stand now, two different bases could lead to
+      //       the same key... BAD!
+      if (vert1id[i1] == 0) {
+        id1++;
+        vert1id[i1] = id1;
+        solution->m_key2.push_back(eqm[p_game->GetPlayer(2)]);
+      }
+      if (vert2id[i2] == 0) {
+        id2++;
+        vert2id[i2] = id2;
+        solution->m_key1.push_back(eqm[p_game->GetPlayer(1)]);
       }
+      solution->m_node1.push_back(vert2id[i2]);
+      solution->m_node2.push_back(vert1id[i1]);
     }
   }
   return solution;
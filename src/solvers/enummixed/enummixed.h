@@ -65,8 +65,11 @@ private:
 
 template <class T> class EnumMixedStrategySolver : public StrategySolver<T> {
 public:
-  explicit EnumMixedStrategySolver(std::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0)
-    : StrategySolver<T>(p_onEquilibrium) {}
+  /// The pairs of vertices are tested on p_threads threads (all
+  /// processors if p_threads <= 0)
+  explicit EnumMixedStrategySolver(std::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0,
+                                   int p_threads = 1)
+    : StrategySolver<T>(p_onEquilibrium), m_threads(p_threads) {}
   virtual ~EnumMixedStrategySolver() = default;
 
   std::shared_ptr<EnumMixedStrategySolution<T> > SolveDetailed(const Game &p_game) const;
@@ -75,6 +78,8 @@ public:
   
   
 private:
+  int m_threads;
+
   /// Implement fuzzy equality for floating-point version when testing Nashness
   static bool EqZero(const T &x);
 };
@@ -22,7 +22,10 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <vector>
 #include "gambit.h"
+#include "core/parallel.h"
 
 using namespace Gambit;
 
@@ -36,6 +39,7 @@ using namespace Gambit;
 
 extern int g_numDecimals;
 extern bool g_verbose;
+extern int g_numThreads;
 
 //
 // A class to organize the data needed to build the polynomials
@@ -386,27 +390,37 @@ void PrintSupport(std::ostream &p_stream,
 
 void EnumPolySolveExtensive(const Game &p_game)
 {
-  List<BehaviorSupportProfile> supports(PossibleNashSubsupports(BehaviorSupportProfile(p_game)));
+  List<BehaviorSupportProfile> supportList(PossibleNashSubsupports(BehaviorSupportProfile(p_game)));
+  std::vector<BehaviorSupportProfile> supports;
+  for (const auto &support : supportList) {
+    supports.push_back(support);
+  }
 
-  for (int i = 1; i <= supports.Length(); i++) {
+  // Supports are solved independently; the output for each is collected
+  // and written in the order of the supports
+  ParallelForOrdered<std::string>(supports.size(), g_numThreads, [&](int i) {
+    const BehaviorSupportProfile &support = supports[i - 1];
+    std::ostringstream output;
     if (g_verbose) {
-      PrintSupport(std::cout, "candidate", supports[i]);
+      PrintSupport(output, "candidate", support);
     }
       
     bool isSingular = false;
     List<MixedBehaviorProfile<double> > newsolns = 
-      SolveSupport(supports[i], isSingular);
+      SolveSupport(support, isSingular);
 
     for (int j = 1; j <= newsolns.Length(); j++) {
       MixedBehaviorProfile<double> fullProfile = ToFullSupport(newsolns[j]);
       if (fullProfile.GetLiapValue(true) < 1.0e-6) {
-	PrintProfile(std::cout, "NE", fullProfile);
+	PrintProfile(output, "NE", fullProfile);
       }
     }
       
     if (isSingular && g_verbose) {
-      PrintSupport(std::cout, "singular", supports[i]);
+      PrintSupport(output, "singular", support);
     }
-  }
+    return output.str();
+  },
+  [](int, const std::string &p_output) { std::cout << p_output << std::flush; });
 }
 
@@ -23,7 +23,10 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <vector>
 
+#include "core/parallel.h"
 #include "nfgensup.h"
 #include "gpoly.h"
 #include "gpolylst.h"
@@ -32,6 +35,7 @@
 
 extern int g_numDecimals;
 extern bool g_verbose; 
+extern int g_numThreads;
 
 class PolEnumModule  {
 private:
@@ -481,35 +485,39 @@ void PrintSupport(std::ostream &p_stream,
 
 void EnumPolySolveStrategic(const Gambit::Game &p_nfg)
 {
-  Gambit::List<Gambit::StrategySupportProfile> supports = PossibleNashSubsupports(p_nfg);
+  Gambit::List<Gambit::StrategySupportProfile> supportList = PossibleNashSubsupports(p_nfg);
+  std::vector<Gambit::StrategySupportProfile> supports;
+  for (const auto &support : supportList) {
+    supports.push_back(support);
+  }
 
-  for (int i = 1; i <= supports.Length(); i++) {
+  // Supports are solved independently; the output for each is collected
+  // and written in the order of the supports
+  Gambit::ParallelForOrdered<std::string>(supports.size(), g_numThreads, [&](int i) {
+    const Gambit::StrategySupportProfile &support = supports[i - 1];
+    std::ostringstream output;
     long newevals = 0;
     double newtime = 0.0;
     Gambit::List<Gambit::MixedStrategyProfile<double> > newsolns;
     bool is_singular = false;
     
     if (g_verbose) {
-      PrintSupport(std::cout, "candidate", supports[i]);
+      PrintSupport(output, "candidate", support);
     }
 
-    PolEnum(supports[i], newsolns, newevals, newtime, is_singular);
+    PolEnum(support, newsolns, newevals, newtime, is_singular);
       
     for (int j = 1; j <= newsolns.Length(); j++) {
       Gambit::MixedStrategyProfile<double> fullProfile = ToFullSupport(newsolns[j]);
       if (fullProfile.GetLiapValue() < 1.0e-6) {
-	PrintProfile(std::cout, "NE", fullProfile);
+	PrintProfile(output, "NE", fullProfile);
       }
     }
 
     if (is_singular && g_verbose) {
-      PrintSupport(std::cout, "singular", supports[i]);
+      PrintSupport(output, "singular", support);
     }
-  }
+    return output.str();
+  },
+  [](int, const std::string &p_output) { std::cout << p_output << std::flush; });
 }
-
-
-
-
-
-
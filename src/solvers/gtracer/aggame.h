@@ -49,12 +49,14 @@ class aggame : public gnmgame {
       :gnmgame(_aggPtr->getNumPlayers(), _aggPtr->actions),
       aggPtr (_aggPtr)
     {
+      aggPtr->initWorkspace(ws);
     }
 
     explicit aggame(Gambit::GameAggRep& g)
       :gnmgame(g.aggPtr->getNumPlayers(), g.aggPtr->actions),
       aggPtr (g.aggPtr)
     {
+      aggPtr->initWorkspace(ws);
     }
 
     virtual ~aggame () {
@@ -139,6 +141,8 @@ class aggame : public gnmgame {
     Gambit::agg::AGG *aggPtr;
 
   private:
+    //the distributions and cached entries of the jacobian computations
+    Gambit::agg::AGG::Workspace ws;
 
   //helper functions for computing jacobian
     void computePartialP_PureNode(int player,int act,std::vector<int>& tasks);
@@ -36,21 +36,27 @@ namespace Nash {
  
 template <class T> class NashLcpStrategySolver : public StrategySolver<T> {
 public:
+  /// Following paths from different equilibria is spread over
+  /// p_threads threads (all processors if p_threads <= 0).  With more
+  /// than one thread, the order in which equilibria are found, and which
+  /// ones are found before stopping after p_stopAfter or within
+  /// p_maxDepth, may vary.
   NashLcpStrategySolver(int p_stopAfter, int p_maxDepth,
-			std::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0)
+			std::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0,
+			int p_threads = 1)
     : StrategySolver<T>(p_onEquilibrium),
-      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth) { }
+      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth), m_threads(p_threads) { }
   virtual ~NashLcpStrategySolver() = default;
 
   virtual List<MixedStrategyProfile<T> > Solve(const Game &) const;
 
 private:
-  int m_stopAfter, m_maxDepth;
+  int m_stopAfter, m_maxDepth, m_threads;
 
   class Solution;
 
   bool OnBFS(const Game &, linalg::LHTableau<T> &, Solution &) const;
-  void AllLemke(const Game &, int j, linalg::LHTableau<T> &, Solution &, int) const;
+  void AllLemke(const Game &, const linalg::LHTableau<T> &, Solution &) const;
 };
 
 inline List<MixedStrategyProfile<double> >
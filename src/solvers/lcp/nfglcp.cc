@@ -21,8 +21,11 @@
 //
 
 #include <iostream>
+#include <memory>
+#include <mutex>
 
 #include "gambit.h"
+#include "core/parallel.h"
 #include "solvers/linalg/lhtab.h"
 #include "solvers/lcp/lcp.h"
 
@@ -110,19 +113,31 @@ template <class T> Vector<T> Make_b2(const Game &p_game)
   return b2;
 }
 
+//
+// A step in the search for equilibria: the tableau reached by following
+// the path for label m_label from the tableau m_from, at depth m_depth.
+// The tableau at depth zero is the extraneous solution itself.
+//
+template <class T> struct LemkeStep {
+  std::shared_ptr<const linalg::LHTableau<T> > m_from;
+  int m_label, m_depth;
+};
+
 }  // end anonymous namespace
   
 
 template <class T>
 class NashLcpStrategySolver<T>::Solution {
 public:
-  List<Gambit::linalg::BFS<T> > m_bfsList;
+  Gambit::linalg::BFSSet<T> m_bfsSet;
   List<MixedStrategyProfile<T> > m_equilibria;
+  /// Held while checking and recording a CBFS, so paths can be followed
+  /// on several threads
+  std::mutex m_lock;
 
-  bool Contains(const Gambit::linalg::BFS<T> &p_bfs) const
-  { return m_bfsList.Contains(p_bfs); }
-  void push_back(const Gambit::linalg::BFS<T> &p_bfs)
-  { m_bfsList.push_back(p_bfs); }
+  /// Records the CBFS, returning false if it had already been recorded
+  bool insert(const Gambit::linalg::BFS<T> &p_bfs)
+  { return m_bfsSet.insert(p_bfs).second; }
 
   int EquilibriumCount() const { return m_equilibria.size(); }
 };
@@ -140,10 +155,14 @@ NashLcpStrategySolver<T>::OnBFS(const Game &p_game,
 				Solution &p_solution) const
 {
   Gambit::linalg::BFS<T> cbfs(p_tableau.GetBFS());
-  if (p_solution.Contains(cbfs)) {
+  std::lock_guard<std::mutex> guard(p_solution.m_lock);
+  if (m_stopAfter > 0 && p_solution.EquilibriumCount() >= m_stopAfter) {
+    // Another thread has already found enough equilibria
+    throw EquilibriumLimitReached();
+  }
+  if (!p_solution.insert(cbfs)) {
     return false;
   }
-  p_solution.push_back(cbfs);
 
   MixedStrategyProfile<T> profile(p_game->NewMixedStrategyProfile(static_cast<T>(0.0)));
   int n1 = p_game->GetPlayer(1)->Strategies().size();
@@ -194,35 +213,41 @@ NashLcpStrategySolver<T>::OnBFS(const Game &p_game,
 }
 
 //
-// AllLemke finds all accessible Nash equilibria by recursively 
-// calling itself.  p_list maintains the list of basic variables 
-// for the equilibria that have already been found.  
-// From each new accessible equilibrium, it follows
-// all possible paths, adding any new equilibria to the List.  
+// AllLemke finds all accessible Nash equilibria by a depth-first search
+// starting from the extraneous solution in p_start.  p_solution maintains
+// the list of basic variables for the equilibria that have already been
+// found.  From each new accessible equilibrium, it follows all possible
+// paths, adding any new equilibria to the List.  Each path is followed
+// on a copy of the tableau at the equilibrium it starts from, so paths
+// can be followed concurrently.
 //
 template <class T> void 
 NashLcpStrategySolver<T>::AllLemke(const Game &p_game,
-				   int j, linalg::LHTableau<T> &B,
-				   Solution &p_solution,
-				   int depth) const
+				   const linalg::LHTableau<T> &p_start,
+				   Solution &p_solution) const
 {
-  if (m_maxDepth != 0 && depth > m_maxDepth) {
-    return;
-  }
-
-  // On the initial depth=0 call, the CBFS we are at is the extraneous
-  // solution.
-  if (depth > 0 && !OnBFS(p_game, B, p_solution)) {
-    return;
-  }
-  
-  for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
-    if (i != j)  {
-      linalg::LHTableau<T> Bcopy(B);
-      Bcopy.LemkePath(i);
-      AllLemke(p_game, i, Bcopy, p_solution, depth+1);
-    }
-  }
+  LemkeStep<T> root { std::make_shared<const linalg::LHTableau<T> >(p_start), 0, 0 };
+  ParallelDepthFirst(root, m_threads,
+    [&](const LemkeStep<T> &p_step, std::vector<LemkeStep<T> > &p_next) {
+      if (m_maxDepth != 0 && p_step.m_depth > m_maxDepth) {
+        return true;
+      }
+      std::shared_ptr<const linalg::LHTableau<T> > tableau = p_step.m_from;
+      if (p_step.m_depth > 0) {
+        auto B = std::make_shared<linalg::LHTableau<T> >(*p_step.m_from);
+        B->LemkePath(p_step.m_label);
+        if (!OnBFS(p_game, *B, p_solution)) {
+          return true;
+        }
+        tableau = B;
+      }
+      for (int i = tableau->MinCol(); i <= tableau->MaxCol(); i++) {
+        if (i != p_step.m_label) {
+          p_next.push_back(LemkeStep<T> { tableau, i, p_step.m_depth + 1 });
+        }
+      }
+      return true;
+    });
 }
 
 template <class T> List<MixedStrategyProfile<T> > 
@@ -244,7 +269,7 @@ NashLcpStrategySolver<T>::Solve(const Game &p_game) const
     linalg::LHTableau<T> B(A1, A2, b1, b2);
 
     if (m_stopAfter != 1) {
-      AllLemke(p_game, 0, B, solution, 0);
+      AllLemke(p_game, B, solution);
     }
     else  {
       B.LemkePath(1);
@@ -20,7 +20,9 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <mutex>
 #include "gambit.h"
+#include "core/parallel.h"
 #include "core/function.h"
 #include "liap.h"
 
@@ -73,33 +75,49 @@ bool AgentLyapunovFunction::Gradient(const Vector<double> &x,
 //                    class NashLiapBehaviorSolver
 //------------------------------------------------------------------------
 
-List<MixedBehaviorProfile<double> >
-NashLiapBehaviorSolver::Solve(const MixedBehaviorProfile<double> &p_start) const
+//
+// Returns true if some profile in the list is within p_tolerance of
+// p_profile in every action probability.  A negative tolerance matches
+// no profile.
+//
+static bool ContainsProfile(const List<MixedBehaviorProfile<double> > &p_list,
+                            const MixedBehaviorProfile<double> &p_profile,
+                            double p_tolerance)
 {
-  if (!p_start.GetGame()->IsPerfectRecall()) {
-    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  if (p_tolerance < 0.0) {
+    return false;
   }
+  for (const auto &profile : p_list) {
+    int i = 1;
+    for (; i <= p_profile.Length() &&
+           std::abs(profile[i] - p_profile[i]) <= p_tolerance; i++);
+    if (i > p_profile.Length()) {
+      return true;
+    }
+  }
+  return false;
+}
 
+//
+// Minimizes the Lyapunov function starting from the profile, leaving the
+// point reached in p_profile.  Returns true if that point is accepted as
+// an equilibrium.
+//
+bool NashLiapBehaviorSolver::Minimize(MixedBehaviorProfile<double> &p) const
+{
   static const double ALPHA = .00000001;
-  List<MixedBehaviorProfile<double> > solutions;
-
-  MixedBehaviorProfile<double> p(p_start);
-  if (m_verbose) {
-    this->m_onEquilibrium->Render(p, "start");
-  }
 
   // if starting vector not interior, perturb it towards centroid
   int kk = 1;
   for (; kk <= p.Length() && p[kk] > ALPHA; kk++);
   if (kk <= p.Length()) {
-    MixedBehaviorProfile<double> c(p_start.GetGame());
+    MixedBehaviorProfile<double> c(p.GetGame());
     for (int k = 1; k <= p.Length(); k++) {
       p[k] = c[k]*ALPHA + p[k]*(1.0-ALPHA);
     }
   }
 
   AgentLyapunovFunction F(p);
-  Matrix<double> xi(p.Length(), p.Length());
   ConjugatePRMinimizer minimizer(p.Length());
   Vector<double> gradient(p.Length()), dx(p.Length());
   double fval;
@@ -115,14 +133,74 @@ NashLiapBehaviorSolver::Solve(const MixedBehaviorProfile<double> &p_start) const
     }
   }
 
-  if (fval < .00001) {
+  return (fval < .00001);
+}
+
+List<MixedBehaviorProfile<double> >
+NashLiapBehaviorSolver::Solve(const MixedBehaviorProfile<double> &p_start) const
+{
+  if (!p_start.GetGame()->IsPerfectRecall()) {
+    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  }
+
+  List<MixedBehaviorProfile<double> > solutions;
+  MixedBehaviorProfile<double> p(p_start);
+  if (m_verbose) {
+    this->m_onEquilibrium->Render(p, "start");
+  }
+  if (Minimize(p)) {
     this->m_onEquilibrium->Render(p, "NE");
     solutions.push_back(p);
   }
   else if (m_verbose) {
     this->m_onEquilibrium->Render(p, "end");
   }
-
   return solutions;
 }
 
+List<MixedBehaviorProfile<double> >
+NashLiapBehaviorSolver::Solve(const List<MixedBehaviorProfile<double> > &p_starts,
+                              int p_threads, int p_stopAfter,
+                              double p_tolerance) const
+{
+  List<MixedBehaviorProfile<double> > solutions;
+  if (p_starts.empty()) {
+    return solutions;
+  }
+  Game game = p_starts.front().GetGame();
+  if (!game->IsPerfectRecall()) {
+    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  }
+  if (p_threads != 1 && !game->IsFrozen()) {
+    throw UndefinedException("Solving from several threads requires a frozen game.");
+  }
+
+  // List::operator[] walks the list from a cached position, which is
+  // neither constant time nor safe to call from several threads
+  std::vector<MixedBehaviorProfile<double> > starts;
+  for (const auto &start : p_starts) {
+    starts.push_back(start);
+  }
+
+  std::mutex lock;
+  ParallelFor(starts.size(), p_threads, [&](int i) {
+    MixedBehaviorProfile<double> p(starts[i - 1]);
+    if (m_verbose) {
+      std::lock_guard<std::mutex> guard(lock);
+      this->m_onEquilibrium->Render(p, "start");
+    }
+    bool found = Minimize(p);
+    std::lock_guard<std::mutex> guard(lock);
+    if (found) {
+      if (!ContainsProfile(solutions, p, p_tolerance)) {
+        this->m_onEquilibrium->Render(p, "NE");
+        solutions.push_back(p);
+      }
+    }
+    else if (m_verbose) {
+      this->m_onEquilibrium->Render(p, "end");
+    }
+    return (p_stopAfter <= 0 || solutions.Length() < p_stopAfter);
+  });
+  return solutions;
+}
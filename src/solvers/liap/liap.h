@@ -38,12 +38,24 @@ public:
   ~NashLiapBehaviorSolver() override = default;
 
   List<MixedBehaviorProfile<double> > Solve(const MixedBehaviorProfile<double> &p_start) const;
+  /// Runs the minimization from each of the starting points, on up to
+  /// p_threads threads (all processors if p_threads <= 0; the game must
+  /// be frozen unless p_threads is 1).  Each equilibrium is rendered as
+  /// soon as it is found.  If p_tolerance is not negative, an equilibrium
+  /// within p_tolerance in every probability of one found earlier is
+  /// skipped.  If p_stopAfter is positive, no further starting points
+  /// are tried once that many equilibria have been reported.
+  List<MixedBehaviorProfile<double> > Solve(const List<MixedBehaviorProfile<double> > &p_starts,
+                                            int p_threads, int p_stopAfter = 0,
+                                            double p_tolerance = -1.0) const;
   List<MixedBehaviorProfile<double> > Solve(const BehaviorSupportProfile &p_support) const override
     { return Solve(MixedBehaviorProfile<double>(p_support)); }
 
 private:
   int m_maxitsN;
   bool m_verbose;
+
+  bool Minimize(MixedBehaviorProfile<double> &) const;
 };
 
 inline List<MixedBehaviorProfile<double> > LiapBehaviorSolve(const Game &p_game, int p_maxitsN)
@@ -61,12 +73,19 @@ public:
   ~NashLiapStrategySolver() override = default;
 
   List<MixedStrategyProfile<double> > Solve(const MixedStrategyProfile<double> &p_start) const;
+  /// Runs the minimization from each of the starting points, as in
+  /// NashLiapBehaviorSolver
+  List<MixedStrategyProfile<double> > Solve(const List<MixedStrategyProfile<double> > &p_starts,
+                                            int p_threads, int p_stopAfter = 0,
+                                            double p_tolerance = -1.0) const;
   List<MixedStrategyProfile<double> > Solve(const Game &p_game) const override
   { return Solve(p_game->NewMixedStrategyProfile(0.0)); }
 
 private:
   int m_maxitsN;
   bool m_verbose;
+
+  bool Minimize(MixedStrategyProfile<double> &) const;
 };
 
 inline List<MixedStrategyProfile<double> > LiapStrategySolve(const Game &p_game, int p_maxitsN)
@@ -20,7 +20,9 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <mutex>
 #include "gambit.h"
+#include "core/parallel.h"
 #include "core/function.h"
 #include "liap.h"
 
@@ -33,48 +35,65 @@ using namespace Gambit;
 class StrategicLyapunovFunction : public FunctionOnSimplices {
 public:
   explicit StrategicLyapunovFunction(const MixedStrategyProfile<double> &p_start)
-    : m_game(p_start.GetGame()), m_profile(p_start)
+    : m_game(p_start.GetGame()), m_profile(p_start),
+      m_values(m_game->NumStrategies()), m_payoffs(m_game->NumPlayers()),
+      m_deriv1(m_game->NumPlayers(), Vector<double>(m_profile.MixedProfileLength())),
+      m_deriv2(m_game->NumPlayers(), Matrix<double>(m_profile.MixedProfileLength(),
+                                                    m_profile.MixedProfileLength()))
   { }
   ~StrategicLyapunovFunction() override = default;
 
 private:
   Game m_game;
   mutable MixedStrategyProfile<double> m_profile;
+  /// The values of the strategies, and the payoffs with their first and
+  /// second derivatives, of each player at the current profile
+  mutable PVector<double> m_values;
+  mutable Array<double> m_payoffs;
+  mutable std::vector<Vector<double> > m_deriv1;
+  mutable std::vector<Matrix<double> > m_deriv2;
 
   double Value(const Vector<double> &) const override;
   bool Gradient(const Vector<double> &, Vector<double> &) const override;
 
-  double LiapDerivValue(int, int, const MixedStrategyProfile<double> &) const;
+  double LiapDerivValue(int, int) const;
 };
 
+//
+// The derivatives are computed from the strategy values and the payoff
+// derivatives stored by Gradient() for the current profile.
+//
 double 
-StrategicLyapunovFunction::LiapDerivValue(int i1, int j1,
-					  const MixedStrategyProfile<double> &p) const
+StrategicLyapunovFunction::LiapDerivValue(int i1, int j1) const
 {
   GameStrategy wrt_strategy = m_game->GetPlayer(i1)->Strategies()[j1];
+  // The index of the strategy in the profile
+  int wrt = j1;
+  for (int i = 1; i < i1; i++) {
+    wrt += m_values.Lengths()[i];
+  }
   double x = 0.0;
-  for (int i = 1; i <= m_game->NumPlayers(); i++) {
+  for (int i = 1, index = 1; i <= m_game->NumPlayers(); i++) {
     double psum = 0.0;
     GamePlayer player = m_game->GetPlayer(i);
-    for (int j = 1; j <= player->NumStrategies(); j++) {
+    for (int j = 1; j <= player->NumStrategies(); j++, index++) {
       GameStrategy strategy = player->Strategies()[j];
-      psum += p[strategy];
-      double x1 = p.GetPayoff(strategy) - p.GetPayoff(i);
+      psum += m_profile[strategy];
+      double x1 = m_values(i, j) - m_payoffs[i];
       if (i1 == i) {
         if (x1 > 0.0)
-          x -= x1 * p.GetPayoffDeriv(i, wrt_strategy);
+          x -= x1 * m_deriv1[i-1][wrt];
       }
       else if (x1 > 0.0) {
-        x += x1 * (p.GetPayoffDeriv(i, strategy, wrt_strategy) -
-                   p.GetPayoffDeriv(i, wrt_strategy));
+        x += x1 * (m_deriv2[i-1](index, wrt) - m_deriv1[i-1][wrt]);
       }
     }
     if (i == i1) {
       x += 100.0 * (psum - 1.0);
     }
   }
-  if (p[wrt_strategy] < 0.0) {
-    x += p[wrt_strategy];
+  if (m_profile[wrt_strategy] < 0.0) {
+    x += m_profile[wrt_strategy];
   }
   return 2.0 * x;
 }
@@ -83,9 +102,13 @@ bool
 StrategicLyapunovFunction::Gradient(const Vector<double> &v, Vector<double> &d) const
 {
   static_cast<Vector<double> &>(m_profile).operator=(v);
+  m_values = m_profile.GetStrategyValues();
+  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
+    m_profile.GetPayoffDerivs(pl, m_payoffs[pl], m_deriv1[pl-1], m_deriv2[pl-1]);
+  }
   for (int pl = 1, ii = 1; pl <= m_game->NumPlayers(); pl++) {
     for (int st = 1; st <= m_game->GetPlayer(pl)->Strategies().size(); st++) {
-      d[ii++] = LiapDerivValue(pl, st, m_profile);
+      d[ii++] = LiapDerivValue(pl, st);
     }
   }
   Project(d, m_game->NumStrategies());
@@ -102,20 +125,37 @@ double StrategicLyapunovFunction::Value(const Vector<double> &v) const
 //                     class NashLiapStrategySolver
 //------------------------------------------------------------------------
 
-List<MixedStrategyProfile<double> > 
-NashLiapStrategySolver::Solve(const MixedStrategyProfile<double> &p_start) const
+//
+// Returns true if some profile in the list is within p_tolerance of
+// p_profile in every strategy probability.  A negative tolerance matches
+// no profile.
+//
+static bool ContainsProfile(const List<MixedStrategyProfile<double> > &p_list,
+                            const MixedStrategyProfile<double> &p_profile,
+                            double p_tolerance)
 {
-  if (!p_start.GetGame()->IsPerfectRecall()) {
-    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  if (p_tolerance < 0.0) {
+    return false;
   }
+  for (const auto &profile : p_list) {
+    int i = 1;
+    for (; i <= p_profile.MixedProfileLength() &&
+           std::abs(profile[i] - p_profile[i]) <= p_tolerance; i++);
+    if (i > p_profile.MixedProfileLength()) {
+      return true;
+    }
+  }
+  return false;
+}
 
+//
+// Minimizes the Lyapunov function starting from the profile, leaving the
+// point reached in p_profile.  Returns true if that point is accepted as
+// an equilibrium.
+//
+bool NashLiapStrategySolver::Minimize(MixedStrategyProfile<double> &p) const
+{
   static const double ALPHA = .00000001;
-  List<MixedStrategyProfile<double> > solutions;
-
-  MixedStrategyProfile<double> p(p_start);
-  if (m_verbose) {
-    this->m_onEquilibrium->Render(p, "start");
-  }
 
   // if starting vector not interior, perturb it towards centroid
   int kk;
@@ -144,17 +184,74 @@ NashLiapStrategySolver::Solve(const MixedStrategyProfile<double> &p_start) const
     }
   }
 
-  if (fval < 0.0001) {
+  return (fval < 0.0001);
+}
+
+List<MixedStrategyProfile<double> > 
+NashLiapStrategySolver::Solve(const MixedStrategyProfile<double> &p_start) const
+{
+  if (!p_start.GetGame()->IsPerfectRecall()) {
+    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  }
+
+  List<MixedStrategyProfile<double> > solutions;
+  MixedStrategyProfile<double> p(p_start);
+  if (m_verbose) {
+    this->m_onEquilibrium->Render(p, "start");
+  }
+  if (Minimize(p)) {
     this->m_onEquilibrium->Render(p, "NE");
     solutions.push_back(p);
   }
   else if (m_verbose) {
     this->m_onEquilibrium->Render(p, "end");
   }
-
   return solutions;
 }
 
+List<MixedStrategyProfile<double> >
+NashLiapStrategySolver::Solve(const List<MixedStrategyProfile<double> > &p_starts,
+                              int p_threads, int p_stopAfter,
+                              double p_tolerance) const
+{
+  List<MixedStrategyProfile<double> > solutions;
+  if (p_starts.empty()) {
+    return solutions;
+  }
+  Game game = p_starts.front().GetGame();
+  if (!game->IsPerfectRecall()) {
+    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  }
+  if (p_threads != 1 && !game->IsFrozen()) {
+    throw UndefinedException("Solving from several threads requires a frozen game.");
+  }
 
+  // List::operator[] walks the list from a cached position, which is
+  // neither constant time nor safe to call from several threads
+  std::vector<MixedStrategyProfile<double> > starts;
+  for (const auto &start : p_starts) {
+    starts.push_back(start);
+  }
 
-
+  std::mutex lock;
+  ParallelFor(starts.size(), p_threads, [&](int i) {
+    MixedStrategyProfile<double> p(starts[i - 1]);
+    if (m_verbose) {
+      std::lock_guard<std::mutex> guard(lock);
+      this->m_onEquilibrium->Render(p, "start");
+    }
+    bool found = Minimize(p);
+    std::lock_guard<std::mutex> guard(lock);
+    if (found) {
+      if (!ContainsProfile(solutions, p, p_tolerance)) {
+        this->m_onEquilibrium->Render(p, "NE");
+        solutions.push_back(p);
+      }
+    }
+    else if (m_verbose) {
+      this->m_onEquilibrium->Render(p, "end");
+    }
+    return (p_stopAfter <= 0 || solutions.Length() < p_stopAfter);
+  });
+  return solutions;
+}
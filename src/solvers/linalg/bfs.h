@@ -25,6 +25,7 @@
 
 #include "gambit.h"
 #include <map>
+#include <unordered_set>
 
 namespace Gambit  {
 
@@ -44,9 +45,10 @@ public:
   bool operator==(const BFS &M) const {
     if (m_map.size() != M.m_map.size())  return false;
 
-    for (typename std::map<int, T>::const_iterator iter = m_map.begin();
-	 iter != m_map.end(); iter++) {
-      if (M.m_map.count((*iter).first) == 0) {
+    // Both maps are ordered by key, so the bases can be compared in step
+    for (auto iter = m_map.begin(), iter2 = M.m_map.begin();
+	 iter != m_map.end(); ++iter, ++iter2) {
+      if (iter->first != iter2->first) {
 	return false;
       }
     }
@@ -54,6 +56,16 @@ public:
   }
   bool operator!=(const BFS &M) const  { return !(*this == M); }
 
+  /// Returns a hash of the basis.  Like equality, this depends only on
+  /// which variables are basic, not on their values.
+  size_t Hash() const {
+    size_t h = m_map.size();
+    for (const auto &entry : m_map) {
+      h ^= std::hash<int>()(entry.first) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+  }
+
   // Provide map-like operations
   int count(int key) const { return (m_map.count(key) > 0); }
 
@@ -72,6 +84,13 @@ public:
   }
 };
 
+template <class T> struct BFSHash {
+  size_t operator()(const BFS<T> &p_bfs) const { return p_bfs.Hash(); }
+};
+
+/// A set of BFSs, for recording which bases have been visited
+template <class T> using BFSSet = std::unordered_set<BFS<T>, BFSHash<T> >;
+
 }  // end namespace Gambit::linalg
 
 }  // end namespace Gambit
@@ -23,8 +23,11 @@
 
 #include <cmath>
 #include <iostream>
+#include <algorithm>
+#include <set>
 #include "gambit.h"
 #include "logbehav.imp"
+#include "linalg.h"
 #include "efglogit.h"
 
 namespace Gambit {
@@ -43,6 +46,13 @@ public:
   // Compute the Jacobian matrix at the specified point.
   void GetJacobian(const Vector<double> &p_point,
 			   Matrix<double> &p_matrix) const override;
+  // Build the pattern of the Jacobian.  The equations for an information
+  // set involve only its own actions, and those at information sets
+  // which precede or follow one of its members.
+  bool GetJacobianPattern(SparseMatrix &p_matrix) const override;
+  // Compute the entries of the Jacobian in the pattern at the point.
+  void GetSparseJacobian(const Vector<double> &p_point,
+			 SparseMatrix &p_matrix) const override;
 
 private:
   //
@@ -51,11 +61,20 @@ private:
   class Equation {
   public:
     virtual ~Equation() = default;
+    // The information set whose actions the equation relates
+    virtual GameInfoset GetInfoset() const = 0;
+    // Whether the equation involves the payoffs to actions, and hence
+    // the play at other information sets, and lambda
+    virtual bool HasPayoffs() const = 0;
     virtual double Value(const LogBehavProfile<double> &p_point,
 			 double p_lambda) const = 0;
-    virtual void Gradient(const LogBehavProfile<double> &p_point, 
-			  double p_lambda,
-			  Vector<double> &p_gradient) const = 0;
+    // The derivative with respect to the log-probability of the action
+    virtual double Derivative(const LogBehavProfile<double> &p_point,
+			      double p_lambda,
+			      const GameAction &p_action) const = 0;
+    // The derivative with respect to lambda
+    virtual double LambdaDerivative(const LogBehavProfile<double> &p_point,
+				    double p_lambda) const = 0;
   };
 
   //
@@ -74,10 +93,15 @@ private:
 	m_infoset(p_game->GetPlayer(p_player)->GetInfoset(p_infoset))
     { }
 
+    GameInfoset GetInfoset() const override { return m_infoset; }
+    bool HasPayoffs() const override { return false; }
     double Value(const LogBehavProfile<double> &p_profile,
 		 double p_lambda) const override;
-    void Gradient(const LogBehavProfile<double> &p_profile, double p_lambda,
-		  Vector<double> &p_gradient) const override;
+    double Derivative(const LogBehavProfile<double> &p_profile, double p_lambda,
+		      const GameAction &p_action) const override;
+    double LambdaDerivative(const LogBehavProfile<double> &p_profile,
+			    double p_lambda) const override
+    { return 0.0; }
   };
 
   //
@@ -97,14 +121,23 @@ private:
 	m_infoset(p_game->GetPlayer(p_player)->GetInfoset(p_infoset))
     { }
 
+    GameInfoset GetInfoset() const override { return m_infoset; }
+    bool HasPayoffs() const override { return true; }
     double Value(const LogBehavProfile<double> &p_profile, 
 		 double p_lambda) const override;
-    void Gradient(const LogBehavProfile<double> &p_profile, double p_lambda,
-		  Vector<double> &p_gradient) const override;
+    double Derivative(const LogBehavProfile<double> &p_profile, double p_lambda,
+		      const GameAction &p_action) const override;
+    double LambdaDerivative(const LogBehavProfile<double> &p_profile,
+			    double p_lambda) const override;
   };
 
   Array<Equation *> m_equations;
+  // The action corresponding to each of the variables
+  Array<GameAction> m_actions;
   const Game &m_game;
+
+  void SetProfile(const Vector<double> &p_point,
+		  LogBehavProfile<double> &p_profile) const;
 };
 
 AgentQREPathTracer::EquationSystem::EquationSystem(const Game &p_game)
@@ -117,6 +150,9 @@ AgentQREPathTracer::EquationSystem::EquationSystem(const Game &p_game)
       for (int act = 2; act <= player->GetInfoset(iset)->NumActions(); act++) {
         m_equations.push_back(new RatioEquation(m_game, pl, iset, act));
       }
+      for (int act = 1; act <= player->GetInfoset(iset)->NumActions(); act++) {
+        m_actions.push_back(player->GetInfoset(iset)->GetAction(act));
+      }
     }
   }
 }
@@ -139,34 +175,13 @@ AgentQREPathTracer::EquationSystem::SumToOneEquation::Value(const LogBehavProfil
   return value;
 }
 
-void
-AgentQREPathTracer::EquationSystem::SumToOneEquation::Gradient(const LogBehavProfile<double> &p_profile,
-							       double p_lambda,
-							       Vector<double> &p_gradient) const
+double
+AgentQREPathTracer::EquationSystem::SumToOneEquation::Derivative(const LogBehavProfile<double> &p_profile,
+								 double p_lambda,
+								 const GameAction &p_action) const
 {
-  int i = 1;
-  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
-    GamePlayer player = m_game->GetPlayer(pl);
-
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      GameInfoset infoset = player->GetInfoset(iset);
-
-      for (int act = 1; act <= infoset->NumActions(); act++, i++) {
-	if (pl == m_pl && iset == m_iset) {
-	  p_gradient[i] = p_profile.GetProb(pl, iset, act);
-	}
-	else {
-	  p_gradient[i] = 0.0;
-	}
-      }
-    }
-  }
-
-  // Derivative wrt lambda is zero
-  p_gradient[i] = 0.0;
+  return (p_action->GetInfoset() == m_infoset) ? p_profile.GetProb(p_action) : 0.0;
 }
-			       
-
 
 double
 AgentQREPathTracer::EquationSystem::RatioEquation::Value(const LogBehavProfile<double> &p_profile,
@@ -179,54 +194,53 @@ AgentQREPathTracer::EquationSystem::RatioEquation::Value(const LogBehavProfile<d
 	   p_profile.GetPayoff(m_infoset->GetAction(1))));
 }
 
-void
-AgentQREPathTracer::EquationSystem::RatioEquation::Gradient(const LogBehavProfile<double> &p_profile,
-							    double p_lambda,
-							    Vector<double> &p_gradient) const
+double
+AgentQREPathTracer::EquationSystem::RatioEquation::Derivative(const LogBehavProfile<double> &p_profile,
+							      double p_lambda,
+							      const GameAction &p_action) const
 {
-  int i = 1;
-  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
-    GamePlayer player = m_game->GetPlayer(pl);
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      GameInfoset infoset = player->GetInfoset(iset);
-      for (int act = 1; act <= infoset->NumActions(); act++, i++) {
-	if (infoset == m_infoset) {
-	  if (act == 1) {
-	    p_gradient[i] = -1.0;
-	  }
-	  else if (act == m_act) {
-	    p_gradient[i] = 1.0; 
-	  }
-	  else {
-	    p_gradient[i] = 0.0;
-	  }
-	}
-	else {   // infoset1 != infoset2
-	  p_gradient[i] = 
-	    -p_lambda * 
-	    (p_profile.DiffActionValue(m_infoset->GetAction(m_act),
-				       infoset->GetAction(act)) -
-	     p_profile.DiffActionValue(m_infoset->GetAction(1),
-				       infoset->GetAction(act)));
-	}
-      }
+  GameInfoset infoset = p_action->GetInfoset();
+  if (infoset == m_infoset) {
+    if (p_action->GetNumber() == 1) {
+      return -1.0;
     }
+    else if (p_action->GetNumber() == m_act) {
+      return 1.0;
+    }
+    else {
+      return 0.0;
+    }
+  }
+  else {   // infoset1 != infoset2
+    return (-p_lambda *
+	    (p_profile.DiffActionValue(m_infoset->GetAction(m_act), p_action) -
+	     p_profile.DiffActionValue(m_infoset->GetAction(1), p_action)));
   }
+}
 
-  p_gradient[i] = (p_profile.GetPayoff(m_infoset->GetAction(1)) -
-		   p_profile.GetPayoff(m_infoset->GetAction(m_act)));
+double
+AgentQREPathTracer::EquationSystem::RatioEquation::LambdaDerivative(const LogBehavProfile<double> &p_profile,
+								    double p_lambda) const
+{
+  return (p_profile.GetPayoff(m_infoset->GetAction(1)) -
+	  p_profile.GetPayoff(m_infoset->GetAction(m_act)));
 }
 
+void
+AgentQREPathTracer::EquationSystem::SetProfile(const Vector<double> &p_point,
+					       LogBehavProfile<double> &p_profile) const
+{
+  for (int i = 1; i <= p_profile.Length(); i++) {
+    p_profile.SetLogProb(i, p_point[i]);
+  }
+}
 
 void
 AgentQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
 					     Vector<double> &p_lhs) const
 {
   LogBehavProfile<double> profile((BehaviorSupportProfile(m_game)));
-  for (int i = 1; i <= profile.Length(); i++) {
-    profile.SetLogProb(i, p_point[i]);
-  }
-
+  SetProfile(p_point, profile);
   double lambda = p_point[p_point.Length()];
 
   for (int i = 1; i <= p_lhs.Length(); i++) {
@@ -239,15 +253,116 @@ AgentQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_point,
 						Matrix<double> &p_matrix) const
 {
   LogBehavProfile<double> profile((BehaviorSupportProfile(m_game)));
-  for (int i = 1; i <= profile.Length(); i++) {
-    profile.SetLogProb(i, p_point[i]);
+  SetProfile(p_point, profile);
+  double lambda = p_point[p_point.Length()];
+
+  for (int i = 1; i <= m_equations.Length(); i++) {
+    for (int j = 1; j <= m_actions.Length(); j++) {
+      p_matrix(j, i) = m_equations[i]->Derivative(profile, lambda, m_actions[j]);
+    }
+    p_matrix(p_point.Length(), i) = m_equations[i]->LambdaDerivative(profile, lambda);
+  }
+}
+
+namespace {
+
+//
+// Records, for each information set, the information sets having a
+// member which precedes or follows one of its members.  The information
+// sets are indexed in order of player and number; p_first gives the
+// index of the first of each player's, and p_path lists those of the
+// information sets preceding p_node.
+//
+void RelateInfosets(const GameNode &p_node, const Array<int> &p_first,
+		    std::vector<int> &p_path,
+		    std::vector<std::set<int> > &p_related)
+{
+  if (p_node->NumChildren() == 0) {
+    return;
+  }
+  GameInfoset infoset = p_node->GetInfoset();
+  bool chance = infoset->GetPlayer()->IsChance();
+  if (!chance) {
+    int index = p_first[infoset->GetPlayer()->GetNumber()] + infoset->GetNumber() - 1;
+    for (auto other : p_path) {
+      if (other != index) {
+        p_related[index].insert(other);
+        p_related[other].insert(index);
+      }
+    }
+    p_path.push_back(index);
+  }
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    RelateInfosets(p_node->GetChild(i), p_first, p_path, p_related);
+  }
+  if (!chance) {
+    p_path.pop_back();
+  }
+}
+
+}  // end anonymous namespace
+
+bool
+AgentQREPathTracer::EquationSystem::GetJacobianPattern(SparseMatrix &p_matrix) const
+{
+  // Index the information sets, and the variables, from zero
+  Array<int> first(m_game->NumPlayers());
+  std::vector<int> firstAction, numActions;
+  for (int pl = 1, offset = 0; pl <= m_game->NumPlayers(); pl++) {
+    GamePlayer player = m_game->GetPlayer(pl);
+    first[pl] = firstAction.size();
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      firstAction.push_back(offset);
+      numActions.push_back(player->GetInfoset(iset)->NumActions());
+      offset += numActions.back();
+    }
   }
+
+  std::vector<std::set<int> > related(firstAction.size());
+  std::vector<int> path;
+  RelateInfosets(m_game->GetRoot(), first, path, related);
+
+  int lambda = m_actions.Length();
+  p_matrix = SparseMatrix(lambda + 1);
+  for (int i = 1; i <= m_equations.Length(); i++) {
+    GameInfoset infoset = m_equations[i]->GetInfoset();
+    int index = first[infoset->GetPlayer()->GetNumber()] + infoset->GetNumber() - 1;
+    std::vector<int> rows;
+    for (int act = 0; act < infoset->NumActions(); act++) {
+      rows.push_back(firstAction[index] + act);
+    }
+    if (m_equations[i]->HasPayoffs()) {
+      for (auto other : related[index]) {
+	for (int act = 0; act < numActions[other]; act++) {
+	  rows.push_back(firstAction[other] + act);
+	}
+      }
+      rows.push_back(lambda);
+    }
+    std::sort(rows.begin(), rows.end());
+    for (auto row : rows) {
+      p_matrix.AddEntry(row);
+    }
+    p_matrix.EndColumn();
+  }
+  return true;
+}
+
+void
+AgentQREPathTracer::EquationSystem::GetSparseJacobian(const Vector<double> &p_point,
+						      SparseMatrix &p_matrix) const
+{
+  LogBehavProfile<double> profile((BehaviorSupportProfile(m_game)));
+  SetProfile(p_point, profile);
   double lambda = p_point[p_point.Length()];
 
   for (int i = 1; i <= m_equations.Length(); i++) {
-    Vector<double> column(p_point.Length());
-    m_equations[i]->Gradient(profile, lambda, column);
-    p_matrix.SetColumn(i, column);
+    for (int p = p_matrix.ColumnStart(i - 1); p < p_matrix.ColumnStart(i); p++) {
+      int row = p_matrix.RowIndex(p);
+      p_matrix.Value(p) = ((row < m_actions.Length()) ?
+			   m_equations[i]->Derivative(profile, lambda, m_actions[row + 1]) :
+			   m_equations[i]->LambdaDerivative(profile, lambda));
+    }
   }
 }
 
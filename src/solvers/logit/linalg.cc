@@ -0,0 +1,565 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/solvers/logit/linalg.cc
+// Dense linear algebra for the path-following algorithm
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include <algorithm>
+
+#include "gambit.h"
+#include "core/sqmatrix.h"  // for SingularMatrixException
+#include "linalg.h"
+
+namespace Gambit {
+
+//----------------------------------------------------------------------------
+//                  QRDecomposition: Auxiliary functions
+//----------------------------------------------------------------------------
+
+//
+// The reflection H_k = I - tau_k v_k v_k^T reduces column k of A.  The
+// vector v_k is zero before entry k and one at entry k; its remaining
+// entries are kept in the row of m_rt for column k, below R(k,k).
+// As in Golub and Van Loan, the reflection maps the column to a
+// nonnegative multiple of the unit vector.  If the column is already
+// reduced, the reflection only changes the sign of entry k if it is
+// negative.  Returns false if no reflection is needed.
+//
+bool QRDecomposition::MakeReflector(int k)
+{
+  double *x = m_rt.Row(k);
+  // Entries are scaled by the largest, as the squares of small entries
+  // may underflow
+  double scale = std::fabs(x[k]);
+  for (int i = k + 1; i < m_rows; i++) {
+    scale = std::max(scale, std::fabs(x[i]));
+  }
+  double alpha = 0.0, sigma = 0.0;
+  if (scale > 0.0) {
+    alpha = x[k] / scale;
+    for (int i = k + 1; i < m_rows; i++) {
+      sigma += (x[i] / scale) * (x[i] / scale);
+    }
+  }
+  if (sigma == 0.0) {
+    // Any entries below k are negligible beside entry k
+    std::fill(x + k + 1, x + m_rows, 0.0);
+    m_tau[k] = (x[k] < 0.0) ? 2.0 : 0.0;
+    x[k] = std::fabs(x[k]);
+    return (m_tau[k] != 0.0);
+  }
+
+  double mu = std::sqrt(alpha * alpha + sigma);
+  double v0;
+  if (alpha <= 0.0) {
+    v0 = alpha - mu;
+    m_tau[k] = 2.0 * v0 * v0 / (sigma + v0 * v0);
+  }
+  else {
+    v0 = -sigma / (alpha + mu);
+    m_tau[k] = 2.0 * sigma / ((alpha + mu) * (alpha + mu) + sigma);
+  }
+  for (int i = k + 1; i < m_rows; i++) {
+    x[i] = (x[i] / scale) / v0;
+  }
+  x[k] = mu * scale;
+  return true;
+}
+
+void QRDecomposition::ApplyReflector(int k, double *p_row) const
+{
+  const double *v = m_rt.Row(k);
+  double w = p_row[k];
+  for (int i = k + 1; i < m_rows; i++) {
+    w += v[i] * p_row[i];
+  }
+  w *= m_tau[k];
+  p_row[k] -= w;
+  for (int i = k + 1; i < m_rows; i++) {
+    p_row[i] -= w * v[i];
+  }
+}
+
+//
+// The product H_j ... H_{j+nb-1} of a block of reflections is written
+// I - V T V^T, where the columns of V are the vectors v_j, ..., v_{j+nb-1}
+// and T is upper triangular (the "compact WY" representation).
+//
+void QRDecomposition::MakeBlock(int j, int nb, DenseMatrix &p_t) const
+{
+  p_t = DenseMatrix(nb, nb);
+  std::vector<double> z(nb);
+  for (int i = 0; i < nb; i++) {
+    const double *vi = m_rt.Row(j + i);
+    double tau = m_tau[j + i];
+    for (int r = 0; r < i; r++) {
+      const double *vr = m_rt.Row(j + r);
+      double dot = vr[j + i];
+      for (int l = j + i + 1; l < m_rows; l++) {
+        dot += vr[l] * vi[l];
+      }
+      z[r] = -tau * dot;
+    }
+    for (int r = 0; r < i; r++) {
+      double s = 0.0;
+      for (int c = r; c < i; c++) {
+        s += p_t(r, c) * z[c];
+      }
+      p_t(r, i) = s;
+    }
+    p_t(i, i) = tau;
+  }
+}
+
+//
+// Applies I - V T V^T, or its transpose, to a vector.  The vectors of V
+// are read once per application, so that the block, which is applied
+// to all rows in turn, stays in cache.
+//
+void QRDecomposition::ApplyBlock(int j, const DenseMatrix &p_t, bool p_transpose,
+                                 double *p_row, std::vector<double> &p_work) const
+{
+  int nb = p_t.NumRows();
+  p_work.resize(2 * nb);
+  double *w = p_work.data(), *tw = p_work.data() + nb;
+  for (int r = 0; r < nb; r++) {
+    const double *v = m_rt.Row(j + r);
+    double s = p_row[j + r];
+    for (int l = j + r + 1; l < m_rows; l++) {
+      s += v[l] * p_row[l];
+    }
+    w[r] = s;
+  }
+  for (int r = 0; r < nb; r++) {
+    double s = 0.0;
+    if (p_transpose) {
+      for (int c = 0; c <= r; c++) {
+        s += p_t(c, r) * w[c];
+      }
+    }
+    else {
+      for (int c = r; c < nb; c++) {
+        s += p_t(r, c) * w[c];
+      }
+    }
+    tw[r] = s;
+  }
+  for (int r = 0; r < nb; r++) {
+    const double *v = m_rt.Row(j + r);
+    p_row[j + r] -= tw[r];
+    for (int l = j + r + 1; l < m_rows; l++) {
+      p_row[l] -= tw[r] * v[l];
+    }
+  }
+}
+
+//
+// Applies to rows p_row1 and p_row2 of R and of Q^T the Givens rotation
+// taking (c1, c2) to (sn, 0), with sn >= 0.  Only columns of R from
+// p_col on are changed; the caller may pass entries of R in column
+// p_col - 1 as c1 and c2.
+//
+void QRDecomposition::Rotate(int p_row1, int p_row2,
+                             double &p_c1, double &p_c2, int p_col)
+{
+  if (std::fabs(p_c1) + std::fabs(p_c2) == 0.0) {
+    return;
+  }
+
+  double sn;
+  if (std::fabs(p_c2) >= std::fabs(p_c1)) {
+    sn = std::sqrt(1.0 + (p_c1/p_c2) * (p_c1/p_c2)) * std::fabs(p_c2);
+  }
+  else {
+    sn = std::sqrt(1.0 + (p_c2/p_c1) * (p_c2/p_c1)) * std::fabs(p_c1);
+  }
+  double s1 = p_c1/sn;
+  double s2 = p_c2/sn;
+
+  double *q1 = m_qt.Row(p_row1), *q2 = m_qt.Row(p_row2);
+  for (int k = 0; k < m_rows; k++) {
+    double sv1 = q1[k], sv2 = q2[k];
+    q1[k] = s1 * sv1 + s2 * sv2;
+    q2[k] = -s2 * sv1 + s1 * sv2;
+  }
+  for (int k = p_col; k < m_cols; k++) {
+    double sv1 = m_rt(k, p_row1), sv2 = m_rt(k, p_row2);
+    m_rt(k, p_row1) = s1 * sv1 + s2 * sv2;
+    m_rt(k, p_row2) = -s2 * sv1 + s1 * sv2;
+  }
+
+  p_c1 = sn;
+  p_c2 = 0.0;
+}
+
+//----------------------------------------------------------------------------
+//                   QRDecomposition: Lifecycle
+//----------------------------------------------------------------------------
+
+QRDecomposition::QRDecomposition(int p_rows, int p_cols)
+  : m_rows(p_rows), m_cols(p_cols),
+    m_rt(p_cols, p_rows), m_qt(p_rows, p_rows), m_tau(p_cols), m_scale(p_rows)
+{ }
+
+//----------------------------------------------------------------------------
+//          QRDecomposition: Computing and updating the decomposition
+//----------------------------------------------------------------------------
+
+//
+// Householder QR is not accurate for matrices whose rows are of widely
+// differing magnitudes, as happens with the Jacobian near the end of a
+// logit path.  The rows of A are therefore first scaled down by powers of
+// two, so that no entry exceeds one in magnitude, and the
+// decomposition is of the scaled matrix DA.  The kernel of the transpose
+// of A, and the solutions of systems in the transpose of A, are then
+// recovered by scaling by D.
+//
+void QRDecomposition::Factor(const Matrix<double> &p_matrix)
+{
+  for (int i = 0; i < m_rows; i++) {
+    double size = 0.0;
+    for (int j = 0; j < m_cols; j++) {
+      size = std::max(size, std::fabs(p_matrix(i + 1, j + 1)));
+    }
+    int exponent = 0;
+    std::frexp(size, &exponent);
+    m_scale[i] = std::ldexp(1.0, -std::max(exponent, 0));
+  }
+  for (int j = 0; j < m_cols; j++) {
+    double *row = m_rt.Row(j);
+    for (int i = 0; i < m_rows; i++) {
+      row[i] = m_scale[i] * p_matrix(i + 1, j + 1);
+    }
+  }
+
+  std::vector<double> work;
+  int reflections = 0;
+  m_blocks.clear();
+  for (int j = 0; j < m_cols; j += c_blockSize) {
+    int nb = std::min(c_blockSize, m_cols - j);
+    for (int k = j; k < j + nb; k++) {
+      if (MakeReflector(k)) {
+        reflections++;
+        for (int c = k + 1; c < j + nb; c++) {
+          ApplyReflector(k, m_rt.Row(c));
+        }
+      }
+    }
+    m_blocks.emplace_back();
+    MakeBlock(j, nb, m_blocks.back());
+    for (int c = j + nb; c < m_cols; c++) {
+      ApplyBlock(j, m_blocks.back(), true, m_rt.Row(c), work);
+    }
+  }
+
+  // Row r of Q^T is Q e_r, obtained by applying the blocks in reverse
+  for (int r = 0; r < m_rows; r++) {
+    double *row = m_qt.Row(r);
+    std::fill(row, row + m_rows, 0.0);
+    row[r] = 1.0;
+    for (int b = m_blocks.size() - 1; b >= 0; b--) {
+      ApplyBlock(b * c_blockSize, m_blocks[b], false, row, work);
+    }
+  }
+  // Each reflection has determinant -1; orient Q by its last column,
+  // which does not enter the product QR.
+  if (reflections % 2 == 1) {
+    double *row = m_qt.Row(m_rows - 1);
+    for (int k = 0; k < m_rows; k++) {
+      row[k] = -row[k];
+    }
+  }
+
+  // Clear out the reflections, leaving R
+  for (int j = 0; j < m_cols; j++) {
+    std::fill(m_rt.Row(j) + j + 1, m_rt.Row(j) + m_rows, 0.0);
+  }
+}
+
+//
+// As in Golub and Van Loan, section 12.5.1: with p = Q^T D u, the
+// rotations which reduce p to a multiple of the first unit vector make R
+// upper Hessenberg; after adding the rank-one term to the first row of R,
+// a second set of rotations restores R to triangular form.  All rotations
+// have determinant one, so the orientation of Q is preserved.
+//
+void QRDecomposition::Update(const Vector<double> &p_u, const Vector<double> &p_v)
+{
+  std::vector<double> p(m_rows);
+  for (int r = 0; r < m_rows; r++) {
+    const double *row = m_qt.Row(r);
+    double s = 0.0;
+    for (int k = 0; k < m_rows; k++) {
+      s += row[k] * m_scale[k] * p_u[k + 1];
+    }
+    p[r] = s;
+  }
+
+  for (int k = m_rows - 1; k >= 1; k--) {
+    Rotate(k - 1, k, p[k - 1], p[k], std::min(k - 1, m_cols));
+  }
+  for (int c = 0; c < m_cols; c++) {
+    m_rt(c, 0) += p[0] * p_v[c + 1];
+  }
+  for (int k = 0; k < m_cols && k + 1 < m_rows; k++) {
+    Rotate(k, k + 1, m_rt(k, k), m_rt(k, k + 1), k + 1);
+  }
+}
+
+//----------------------------------------------------------------------------
+//                QRDecomposition: Using the decomposition
+//----------------------------------------------------------------------------
+
+void QRDecomposition::GetKernel(Vector<double> &p_column) const
+{
+  // The last column of Q spans the kernel of (DA)^T; scaling by D gives
+  // the kernel of A^T, with the same orientation.
+  const double *row = m_qt.Row(m_rows - 1);
+  double norm = 0.0;
+  for (int k = 0; k < m_rows; k++) {
+    p_column[k + 1] = m_scale[k] * row[k];
+    norm += p_column[k + 1] * p_column[k + 1];
+  }
+  norm = std::sqrt(norm);
+  for (int k = 1; k <= m_rows; k++) {
+    p_column[k] /= norm;
+  }
+}
+
+void QRDecomposition::MultiplyTranspose(const Vector<double> &p_x,
+                                        Vector<double> &p_y) const
+{
+  std::vector<double> qx(m_cols);
+  for (int r = 0; r < m_cols; r++) {
+    const double *row = m_qt.Row(r);
+    double s = 0.0;
+    for (int k = 0; k < m_rows; k++) {
+      s += row[k] * p_x[k + 1] / m_scale[k];
+    }
+    qx[r] = s;
+  }
+  for (int c = 0; c < m_cols; c++) {
+    const double *col = m_rt.Row(c);
+    double s = 0.0;
+    for (int k = 0; k <= c; k++) {
+      s += col[k] * qx[k];
+    }
+    p_y[c + 1] = s;
+  }
+}
+
+//
+// Q R^{-T} y solves (DA)^T z = y, so x = Dz solves A^T x = y; the
+// least-norm solution is its projection onto the complement of the kernel.
+//
+double QRDecomposition::SolveTranspose(const Vector<double> &p_y,
+                                       Vector<double> &p_x) const
+{
+  std::vector<double> z(m_cols);
+  for (int k = 0; k < m_cols; k++) {
+    const double *col = m_rt.Row(k);
+    double s = p_y[k + 1];
+    for (int l = 0; l < k; l++) {
+      s -= col[l] * z[l];
+    }
+    z[k] = s / col[k];
+  }
+
+  std::vector<double> x(m_rows, 0.0);
+  for (int l = 0; l < m_cols; l++) {
+    const double *row = m_qt.Row(l);
+    for (int k = 0; k < m_rows; k++) {
+      x[k] += z[l] * row[k];
+    }
+  }
+
+  Vector<double> t(m_rows);
+  GetKernel(t);
+  double proj = 0.0;
+  for (int k = 0; k < m_rows; k++) {
+    x[k] *= m_scale[k];
+    proj += x[k] * t[k + 1];
+  }
+  double norm = 0.0;
+  for (int k = 0; k < m_rows; k++) {
+    p_x[k + 1] = x[k] - proj * t[k + 1];
+    norm += p_x[k + 1] * p_x[k + 1];
+  }
+  return std::sqrt(norm);
+}
+
+//----------------------------------------------------------------------------
+//                   SparseLUDecomposition: Member functions
+//----------------------------------------------------------------------------
+
+//
+// Column k of the factors is computed by solving L x = A(:,k), where L
+// holds the columns of L computed so far.  Its rows are indexed as those
+// of A; row i has been chosen as the pivot of column m_pinv[i] of L, or
+// not yet chosen if that is negative.  Entries of x in rows already
+// chosen make up column k of U; the largest of the others is the pivot,
+// and the rest, divided by it, make up column k of L.
+//
+// The nonzero entries of x are those reachable from the entries of
+// A(:,k) in the graph of L, and an order in which to eliminate them is
+// given by a depth-first search of that graph.
+//
+void SparseLUDecomposition::Factor(const SparseMatrix &p_matrix)
+{
+  m_size = p_matrix.NumRows();
+  m_lower = SparseMatrix(m_size);
+  m_upper = SparseMatrix(m_size);
+  m_pinv.assign(m_size, -1);
+
+  std::vector<double> x(m_size, 0.0);
+  // The pattern of x is built in topological order at the back of
+  // pattern; stack and next are for the depth-first search
+  std::vector<int> pattern(m_size), stack(m_size), next(m_size);
+  std::vector<int> visited(m_size, -1);
+
+  for (int k = 0; k < m_size; k++) {
+    int top = m_size;
+    for (int p = p_matrix.ColumnStart(k); p < p_matrix.ColumnStart(k + 1); p++) {
+      int i = p_matrix.RowIndex(p);
+      if (visited[i] == k) {
+        continue;
+      }
+      int head = 0;
+      stack[0] = i;
+      while (head >= 0) {
+        int j = stack[head], col = m_pinv[j];
+        if (visited[j] != k) {
+          visited[j] = k;
+          next[head] = (col < 0) ? 0 : m_lower.ColumnStart(col) + 1;
+        }
+        int end = (col < 0) ? 0 : m_lower.ColumnStart(col + 1);
+        bool done = true;
+        for (int q = next[head]; q < end; q++) {
+          int child = m_lower.RowIndex(q);
+          if (visited[child] != k) {
+            next[head] = q + 1;
+            stack[++head] = child;
+            done = false;
+            break;
+          }
+        }
+        if (done) {
+          head--;
+          pattern[--top] = j;
+        }
+      }
+    }
+
+    for (int p = top; p < m_size; p++) {
+      x[pattern[p]] = 0.0;
+    }
+    for (int p = p_matrix.ColumnStart(k); p < p_matrix.ColumnStart(k + 1); p++) {
+      x[p_matrix.RowIndex(p)] = p_matrix.Value(p);
+    }
+    for (int p = top; p < m_size; p++) {
+      int j = pattern[p], col = m_pinv[j];
+      if (col < 0) {
+        continue;
+      }
+      for (int q = m_lower.ColumnStart(col) + 1; q < m_lower.ColumnStart(col + 1); q++) {
+        x[m_lower.RowIndex(q)] -= m_lower.Value(q) * x[j];
+      }
+    }
+
+    int pivot = -1;
+    double largest = 0.0;
+    for (int p = top; p < m_size; p++) {
+      int i = pattern[p];
+      if (m_pinv[i] < 0) {
+        if (std::fabs(x[i]) > largest) {
+          largest = std::fabs(x[i]);
+          pivot = i;
+        }
+      }
+      else {
+        m_upper.AddEntry(m_pinv[i], x[i]);
+      }
+    }
+    if (pivot < 0) {
+      throw SingularMatrixException();
+    }
+    if (m_pinv[k] < 0 && std::fabs(x[k]) >= m_threshold * largest) {
+      pivot = k;
+    }
+
+    double value = x[pivot];
+    m_upper.AddEntry(k, value);
+    m_upper.EndColumn();
+    m_pinv[pivot] = k;
+    m_lower.AddEntry(pivot, 1.0);
+    for (int p = top; p < m_size; p++) {
+      int i = pattern[p];
+      if (m_pinv[i] < 0) {
+        m_lower.AddEntry(i, x[i] / value);
+      }
+      x[i] = 0.0;
+    }
+    m_lower.EndColumn();
+  }
+
+  // The determinant is the product of the diagonal of U, with the sign
+  // of the permutation
+  m_sign = 1;
+  for (int k = 0; k < m_size; k++) {
+    if (m_upper.Value(m_upper.ColumnStart(k + 1) - 1) < 0.0) {
+      m_sign = -m_sign;
+    }
+  }
+  std::vector<bool> seen(m_size, false);
+  for (int i = 0; i < m_size; i++) {
+    for (int j = m_pinv[i]; !seen[j]; j = m_pinv[j]) {
+      seen[j] = true;
+      if (j != i) {
+        m_sign = -m_sign;
+      }
+    }
+  }
+}
+
+void SparseLUDecomposition::Solve(std::vector<double> &p_rhs) const
+{
+  std::vector<double> x(m_size);
+  for (int i = 0; i < m_size; i++) {
+    x[m_pinv[i]] = p_rhs[i];
+  }
+  // L has a unit diagonal, which is the first entry of each column; its
+  // row indices are those of A, and must be permuted
+  for (int j = 0; j < m_size; j++) {
+    for (int p = m_lower.ColumnStart(j) + 1; p < m_lower.ColumnStart(j + 1); p++) {
+      x[m_pinv[m_lower.RowIndex(p)]] -= m_lower.Value(p) * x[j];
+    }
+  }
+  // The diagonal of U is the last entry of each column
+  for (int j = m_size - 1; j >= 0; j--) {
+    int last = m_upper.ColumnStart(j + 1) - 1;
+    x[j] /= m_upper.Value(last);
+    for (int p = m_upper.ColumnStart(j); p < last; p++) {
+      x[m_upper.RowIndex(p)] -= m_upper.Value(p) * x[j];
+    }
+  }
+  p_rhs = x;
+}
+
+}  // end namespace Gambit
@@ -0,0 +1,229 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/solvers/logit/linalg.h
+// Dense linear algebra for the path-following algorithm
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LINALG_H
+#define LINALG_H
+
+#include <vector>
+#include "core/vector.h"
+#include "core/matrix.h"
+
+namespace Gambit {
+
+///
+/// A dense matrix of doubles, stored contiguously in row-major order.
+/// Unlike Matrix<T>, entries are indexed from zero and accesses are not
+/// bounds-checked; this is intended for the inner loops of numerical
+/// kernels.
+///
+class DenseMatrix {
+public:
+  /// @name Lifecycle
+  //@{
+  DenseMatrix() : m_rows(0), m_cols(0) { }
+  DenseMatrix(int p_rows, int p_cols)
+    : m_rows(p_rows), m_cols(p_cols), m_data(p_rows * p_cols, 0.0) { }
+  //@}
+
+  /// @name Data access
+  //@{
+  int NumRows() const { return m_rows; }
+  int NumColumns() const { return m_cols; }
+
+  double &operator()(int i, int j) { return m_data[i * m_cols + j]; }
+  const double &operator()(int i, int j) const { return m_data[i * m_cols + j]; }
+
+  /// Returns a pointer to the start of the i'th row
+  double *Row(int i) { return m_data.data() + i * m_cols; }
+  /// Returns a pointer to the start of the i'th row
+  const double *Row(int i) const { return m_data.data() + i * m_cols; }
+  //@}
+
+private:
+  int m_rows, m_cols;
+  std::vector<double> m_data;
+};
+
+///
+/// The QR decomposition A = QR of an n-by-m matrix A, with n >= m.
+/// The decomposition is computed by blocked Householder reflections, and
+/// can subsequently be updated in O(n^2) operations to that of a rank-one
+/// modification of A.
+///
+/// To preserve accuracy when the rows of A are of very different
+/// magnitudes, the decomposition is of DA, where D is a diagonal scaling
+/// of the rows by powers of two.  The operations below are all expressed
+/// in terms of A itself.
+///
+/// Q is kept explicitly, and is oriented so that its determinant is one,
+/// and the diagonal entries of R are nonnegative.  This is the same
+/// orientation as computed by Givens rotations, so that when n = m + 1,
+/// the kernel of the transpose of A has the same orientation.
+///
+/// Internally, R and Q are both stored transposed, so that the columns of
+/// A being reduced, and the columns of Q, are contiguous.
+///
+class QRDecomposition {
+public:
+  /// @name Lifecycle
+  //@{
+  QRDecomposition(int p_rows, int p_cols);
+  //@}
+
+  /// @name Computing and updating the decomposition
+  //@{
+  /// Computes the decomposition of the matrix
+  void Factor(const Matrix<double> &p_matrix);
+  /// Updates the decomposition to that of A + u v^T
+  void Update(const Vector<double> &p_u, const Vector<double> &p_v);
+  //@}
+
+  /// @name Using the decomposition
+  //@{
+  /// \brief Returns the unit vector spanning the kernel of A^T
+  ///
+  /// When n = m + 1, this is the last column of Q, scaled by D and
+  /// normalized.
+  void GetKernel(Vector<double> &p_column) const;
+  /// Computes A^T x
+  void MultiplyTranspose(const Vector<double> &p_x, Vector<double> &p_y) const;
+  /// \brief Computes the least-norm solution of A^T x = y
+  ///
+  /// Solves by the triangular factor, and the first m columns of Q, and
+  /// then projects out the kernel of A^T, so that n = m + 1 is assumed.
+  /// Returns the norm of x.
+  double SolveTranspose(const Vector<double> &p_y, Vector<double> &p_x) const;
+  //@}
+
+private:
+  static const int c_blockSize = 32;
+
+  int m_rows, m_cols;
+  /// The transpose of R.  During factoring, the Householder vectors are
+  /// kept below the diagonal of R, that is, in the row of its column.
+  DenseMatrix m_rt;
+  /// The transpose of Q
+  DenseMatrix m_qt;
+  /// The scalar factors of the Householder reflections
+  std::vector<double> m_tau;
+  /// The scaling D of the rows of A; the decomposition is of DA
+  std::vector<double> m_scale;
+  /// The triangular factors of each block of reflections
+  std::vector<DenseMatrix> m_blocks;
+
+  /// @name Private auxiliary functions
+  //@{
+  bool MakeReflector(int k);
+  void ApplyReflector(int k, double *p_row) const;
+  void MakeBlock(int j, int nb, DenseMatrix &p_t) const;
+  void ApplyBlock(int j, const DenseMatrix &p_t, bool p_transpose,
+                  double *p_row, std::vector<double> &p_work) const;
+  void Rotate(int p_row1, int p_row2, double &p_c1, double &p_c2, int p_col);
+  //@}
+};
+
+///
+/// A sparse matrix of doubles, stored in compressed column form.  The
+/// matrix is built column by column, by adding the entries of the last
+/// column in turn and then closing it; the pattern of entries is then
+/// fixed, but their values may be set freely.  As with DenseMatrix,
+/// entries are indexed from zero.
+///
+class SparseMatrix {
+public:
+  /// @name Lifecycle
+  //@{
+  SparseMatrix() : m_rows(0), m_start(1, 0) { }
+  /// Constructs a matrix with the given number of rows and no columns
+  explicit SparseMatrix(int p_rows) : m_rows(p_rows), m_start(1, 0) { }
+  //@}
+
+  /// @name Building the matrix
+  //@{
+  /// Adds an entry in the given row to the last column
+  void AddEntry(int p_row, double p_value = 0.0)
+  { m_index.push_back(p_row);  m_values.push_back(p_value); }
+  /// Closes the last column, beginning a new one
+  void EndColumn() { m_start.push_back(m_index.size()); }
+  //@}
+
+  /// @name Data access
+  //@{
+  int NumRows() const { return m_rows; }
+  int NumColumns() const { return m_start.size() - 1; }
+  int NumNonzeros() const { return m_index.size(); }
+
+  /// The entries of column j are in positions ColumnStart(j) up to, but
+  /// not including, ColumnStart(j + 1)
+  int ColumnStart(int j) const { return m_start[j]; }
+  int RowIndex(int p) const { return m_index[p]; }
+  double &Value(int p) { return m_values[p]; }
+  const double &Value(int p) const { return m_values[p]; }
+  //@}
+
+private:
+  int m_rows;
+  std::vector<int> m_start, m_index;
+  std::vector<double> m_values;
+};
+
+///
+/// The LU decomposition PA = LU of a sparse square matrix A, with partial
+/// pivoting.  The factors are computed column by column, following
+/// Gilbert and Peierls: each column of L and U is obtained by a sparse
+/// triangular solve against the columns already computed, whose pattern
+/// is found by a depth-first search.  The work is therefore proportional
+/// to the number of floating-point operations, rather than to the square
+/// of the size of A.  The columns of A are taken in their given order.
+///
+class SparseLUDecomposition {
+public:
+  /// @name Lifecycle
+  //@{
+  /// Sets the threshold for pivoting: the diagonal entry is preferred
+  /// as the pivot if it is at least this fraction of the largest
+  explicit SparseLUDecomposition(double p_threshold = 0.1)
+    : m_threshold(p_threshold), m_size(0), m_sign(1) { }
+  //@}
+
+  /// @name Computing and using the decomposition
+  //@{
+  /// Computes the decomposition of the matrix; throws a
+  /// SingularMatrixException if it is singular
+  void Factor(const SparseMatrix &p_matrix);
+  /// Solves Ax = b, overwriting b with x
+  void Solve(std::vector<double> &p_rhs) const;
+  /// Returns the sign of the determinant of A
+  int GetDeterminantSign() const { return m_sign; }
+  //@}
+
+private:
+  double m_threshold;
+  int m_size, m_sign;
+  SparseMatrix m_lower, m_upper;
+  /// m_pinv[i] is the row of L and U to which row i of A is permuted
+  std::vector<int> m_pinv;
+};
+
+}  // end namespace Gambit
+
+#endif  // LINALG_H
@@ -36,7 +36,11 @@ namespace Gambit {
 
 class StrategicQREPathTracer::EquationSystem : public PathTracer::EquationSystem {
 public:
-  explicit EquationSystem(const Game &p_game) : m_game(p_game) { }
+  explicit EquationSystem(const Game &p_game)
+    : m_game(p_game), m_profile(p_game->NewMixedStrategyProfile(0.0)),
+      m_deriv1(m_profile.MixedProfileLength()),
+      m_deriv2(m_profile.MixedProfileLength(), m_profile.MixedProfileLength())
+  { }
   ~EquationSystem() override = default;
   // Compute the value of the system of equations at the specified point.
   void GetValue(const Vector<double> &p_point,
@@ -47,18 +51,31 @@ public:
 
 private:
   Game m_game;
+  // Scratch space, reused across calls: the profile at the point, and
+  // the derivatives of one player's payoff at that profile
+  mutable MixedStrategyProfile<double> m_profile;
+  mutable Vector<double> m_deriv1;
+  mutable Matrix<double> m_deriv2;
+
+  // Set the profile to the one represented by the point
+  void SetProfile(const Vector<double> &p_point) const;
 };
 
+void
+StrategicQREPathTracer::EquationSystem::SetProfile(const Vector<double> &p_point) const
+{
+  for (int i = 1; i <= m_profile.MixedProfileLength(); i++) {
+    m_profile[i] = exp(p_point[i]);
+  }
+}
+
 void 
 StrategicQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
 						 Vector<double> &p_lhs) const
 {
-  MixedStrategyProfile<double> profile(m_game->NewMixedStrategyProfile(0.0)), logprofile(m_game->NewMixedStrategyProfile(0.0));
-  for (int i = 1; i <= profile.MixedProfileLength(); i++) {
-    profile[i] = exp(p_point[i]);
-    logprofile[i] = p_point[i];
-  }
+  SetProfile(p_point);
   double lambda = p_point[p_point.Length()];
+  PVector<double> values = m_profile.GetStrategyValues();
   p_lhs = 0.0;
   for (int rowno = 0, pl = 1; pl <= m_game->NumPlayers(); pl++) {
     GamePlayer player = m_game->GetPlayer(pl);
@@ -68,51 +85,48 @@ StrategicQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
 	// This is a sum-to-one equation
 	p_lhs[rowno] = -1.0;
 	for (size_t j = 1; j <= player->Strategies().size(); j++) {
-	  p_lhs[rowno] += profile[player->GetStrategy(j)];
+	  p_lhs[rowno] += m_profile[player->GetStrategy(j)];
 	}
       }
       else {
 	// This is a ratio equation
-	p_lhs[rowno] = (logprofile[player->GetStrategy(st)] - 
-			logprofile[player->GetStrategy(1)] -
-			lambda * (profile.GetPayoff(player->GetStrategy(st)) -
-				  profile.GetPayoff(player->GetStrategy(1))));
-
+	p_lhs[rowno] = (p_point[rowno] - p_point[rowno - st + 1] -
+			lambda * (values(pl, st) - values(pl, 1)));
       }
     }
   }
 }
 
+//
+// The rows of the ratio equations for player i are filled from the
+// payoff derivatives of player i, which are computed together in one
+// pass over the game.  Rows and columns are both indexed as the
+// strategies in the profile.
+//
 void
 StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_point,
 						    Matrix<double> &p_matrix) const
 {
-  MixedStrategyProfile<double> profile(m_game->NewMixedStrategyProfile(0.0)), logprofile(m_game->NewMixedStrategyProfile(0.0));
-  for (int i = 1; i <= profile.MixedProfileLength(); i++) {
-    profile[i] = exp(p_point[i]);
-    logprofile[i] = p_point[i];
-  }
+  SetProfile(p_point);
   double lambda = p_point[p_point.Length()];
 
   p_matrix = 0.0;
 
   for (int rowno = 0, i = 1; i <= m_game->NumPlayers(); i++) {
     GamePlayer player = m_game->GetPlayer(i);
+    double payoff;
+    m_profile.GetPayoffDerivs(i, payoff, m_deriv1, m_deriv2);
+    // The row of the first strategy of player i
+    int first = rowno + 1;
     for (size_t j = 1; j <= player->Strategies().size(); j++) {
       rowno++;
       if (j == 1) {
 	// This is a sum-to-one equation
-	for (int colno = 0, ell = 1; ell <= m_game->NumPlayers(); ell++) {
-	  GamePlayer player2 = m_game->GetPlayer(ell);
-	  for (size_t m = 1; m <= player2->Strategies().size(); m++) {
-	    colno++;
-	    if (i == ell) {
-	      p_matrix(colno, rowno) = profile[player2->GetStrategy(m)];
-	    }
-	    // Otherwise, entry is zero
-	  }
+	for (size_t m = 1; m <= player->Strategies().size(); m++) {
+	  p_matrix(first + m - 1, rowno) = m_profile[player->GetStrategy(m)];
 	}
-	// The last column is derivative wrt lamba, which is zero
+	// Entries for other players' strategies are zero, as is the
+	// last column, the derivative wrt lambda
       }
       else {
 	// This is a ratio equation
@@ -131,25 +145,208 @@ StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_poin
 	    }
 	    else {
 	      p_matrix(colno, rowno) =
-		-lambda * profile[player2->GetStrategy(m)] *
-		(profile.GetPayoffDeriv(i, 
-					player->GetStrategy(j),
-					player2->GetStrategy(m)) -
-		 profile.GetPayoffDeriv(i, 
-					player->GetStrategy(1),
-					player2->GetStrategy(m)));
+		-lambda * m_profile[colno] *
+		(m_deriv2(rowno, colno) - m_deriv2(first, colno));
 	    }
 	  }
 	}
 	// Fill the last column, the derivative wrt lambda
-	p_matrix(p_matrix.NumRows(), rowno) =
-	  (profile.GetPayoff(player->GetStrategy(1)) - 
-	   profile.GetPayoff(player->GetStrategy(j)));
+	p_matrix(p_matrix.NumRows(), rowno) = m_deriv1[first] - m_deriv1[rowno];
       }
     }
   }
 }
 
+//------------------------------------------------------------------------------
+//       StrategicQREPathTracer: Equations for symmetric action-graph games
+//------------------------------------------------------------------------------
+
+//
+// In an action-graph game, players with the same actions are
+// interchangeable, and along the principal branch all players in such a
+// class play the same strategy.  The branch then solves a system with
+// one player standing for each class, whose size does not grow with the
+// number of players.  Payoffs are computed on the full profile, which is
+// exactly symmetric within classes, so the computation of the Jacobian
+// of the representative's payoffs shares its work across each class.  A
+// class's strategy moves with those of all its members, so its column
+// sums the entries of all members but the representative.
+//
+class StrategicQREPathTracer::SymmetricEquationSystem : public PathTracer::EquationSystem {
+public:
+  explicit SymmetricEquationSystem(const Game &p_game);
+  ~SymmetricEquationSystem() override = default;
+
+  // Whether the game has classes of more than one player, and the
+  // profile gives all players in each class the same strategy
+  static bool IsApplicable(const MixedStrategyProfile<double> &p_profile);
+
+  // Convert points of the full system to points of this one, and back
+  Vector<double> Reduce(const Vector<double> &p_point) const;
+  Vector<double> Expand(const Vector<double> &p_point) const;
+
+  void GetValue(const Vector<double> &p_point,
+                Vector<double> &p_lhs) const override;
+  void GetJacobian(const Vector<double> &p_point,
+                   Matrix<double> &p_matrix) const override;
+
+private:
+  agg::AGG *m_agg;
+  // For each class, its representative player, and the index of the
+  // representative's first strategy in the points of this system
+  Array<int> m_players, m_first;
+  // For each strategy in the full profile, its index in this system
+  Array<int> m_index;
+  // Scratch space, reused across calls: the full profile at the point,
+  // and the payoffs of one representative and their derivatives
+  mutable std::vector<double> m_probs, m_values;
+  mutable std::vector<std::vector<double> > m_jacobian;
+  mutable Matrix<double> m_derivs;
+
+  void SetProfile(const Vector<double> &p_point) const;
+};
+
+StrategicQREPathTracer::SymmetricEquationSystem::SymmetricEquationSystem(const Game &p_game)
+  : m_agg(dynamic_cast<GameAggRep &>(*p_game).GetUnderlyingAGG()),
+    m_index(m_agg->getNumActions()),
+    m_probs(m_agg->getNumActions()), m_values(m_agg->getMaxActions()),
+    m_jacobian(m_agg->getMaxActions(), std::vector<double>(m_agg->getNumActions()))
+{
+  int length = 0;
+  for (int c = 0; c < m_agg->getNumPlayerClasses(); c++) {
+    int player = m_agg->getPlayerClass(c)[0];
+    m_players.push_back(player);
+    m_first.push_back(length + 1);
+    for (int member : m_agg->getPlayerClass(c)) {
+      for (int j = 0; j < m_agg->getNumActions(player); j++) {
+        m_index[m_agg->firstAction(member) + j + 1] = length + j + 1;
+      }
+    }
+    length += m_agg->getNumActions(player);
+  }
+  m_derivs = Matrix<double>(m_agg->getMaxActions(), length);
+}
+
+bool
+StrategicQREPathTracer::SymmetricEquationSystem::IsApplicable(const MixedStrategyProfile<double> &p_profile)
+{
+  if (!p_profile.GetGame()->IsAgg()) {
+    return false;
+  }
+  agg::AGG *aggPtr = dynamic_cast<GameAggRep &>(*p_profile.GetGame()).GetUnderlyingAGG();
+  if (aggPtr->getNumPlayerClasses() == aggPtr->getNumPlayers()) {
+    return false;
+  }
+  for (int c = 0; c < aggPtr->getNumPlayerClasses(); c++) {
+    int player = aggPtr->getPlayerClass(c)[0];
+    for (int member : aggPtr->getPlayerClass(c)) {
+      // Members listing the same actions in another order are not
+      // treated as one class
+      if (aggPtr->getActionSet(member) != aggPtr->getActionSet(player)) {
+        return false;
+      }
+      for (int j = 1; j <= aggPtr->getNumActions(player); j++) {
+        if (p_profile[aggPtr->firstAction(member) + j] !=
+            p_profile[aggPtr->firstAction(player) + j]) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+Vector<double>
+StrategicQREPathTracer::SymmetricEquationSystem::Reduce(const Vector<double> &p_point) const
+{
+  Vector<double> point(m_derivs.NumColumns() + 1);
+  for (int c = 1; c <= m_players.Length(); c++) {
+    for (int j = 0; j < m_agg->getNumActions(m_players[c]); j++) {
+      point[m_first[c] + j] = p_point[m_agg->firstAction(m_players[c]) + j + 1];
+    }
+  }
+  point[point.Length()] = p_point[p_point.Length()];
+  return point;
+}
+
+Vector<double>
+StrategicQREPathTracer::SymmetricEquationSystem::Expand(const Vector<double> &p_point) const
+{
+  Vector<double> point(m_index.Length() + 1);
+  for (int i = 1; i <= m_index.Length(); i++) {
+    point[i] = p_point[m_index[i]];
+  }
+  point[point.Length()] = p_point[p_point.Length()];
+  return point;
+}
+
+void
+StrategicQREPathTracer::SymmetricEquationSystem::SetProfile(const Vector<double> &p_point) const
+{
+  for (int i = 1; i <= m_index.Length(); i++) {
+    m_probs[i - 1] = exp(p_point[m_index[i]]);
+  }
+}
+
+void
+StrategicQREPathTracer::SymmetricEquationSystem::GetValue(const Vector<double> &p_point,
+                                                          Vector<double> &p_lhs) const
+{
+  SetProfile(p_point);
+  double lambda = p_point[p_point.Length()];
+  for (int c = 1; c <= m_players.Length(); c++) {
+    m_agg->computePayoffVector(m_values, m_players[c], m_probs);
+    int first = m_first[c];
+    int numActions = m_agg->getNumActions(m_players[c]);
+    // The sum-to-one equation, then the ratio equations
+    p_lhs[first] = -1.0;
+    for (int j = 0; j < numActions; j++) {
+      p_lhs[first] += exp(p_point[first + j]);
+    }
+    for (int j = 1; j < numActions; j++) {
+      p_lhs[first + j] = (p_point[first + j] - p_point[first] -
+                          lambda * (m_values[j] - m_values[0]));
+    }
+  }
+}
+
+void
+StrategicQREPathTracer::SymmetricEquationSystem::GetJacobian(const Vector<double> &p_point,
+                                                             Matrix<double> &p_matrix) const
+{
+  SetProfile(p_point);
+  double lambda = p_point[p_point.Length()];
+  p_matrix = 0.0;
+
+  for (int c = 1; c <= m_players.Length(); c++) {
+    int player = m_players[c];
+    int first = m_first[c];
+    int numActions = m_agg->getNumActions(player);
+    m_agg->computePayoffJacobian(m_values, m_jacobian, player, m_probs);
+    m_derivs = 0.0;
+    for (int j = 0; j < numActions; j++) {
+      for (int k = 1; k <= m_index.Length(); k++) {
+        m_derivs(j + 1, m_index[k]) += m_jacobian[j][k - 1];
+      }
+    }
+
+    for (int j = 0; j < numActions; j++) {
+      p_matrix(first + j, first) = exp(p_point[first + j]);
+    }
+    for (int j = 1; j < numActions; j++) {
+      int rowno = first + j;
+      for (int colno = 1; colno <= m_derivs.NumColumns(); colno++) {
+        p_matrix(colno, rowno) =
+          -lambda * exp(p_point[colno]) *
+          (m_derivs(j + 1, colno) - m_derivs(1, colno));
+      }
+      p_matrix(first, rowno) -= 1.0;
+      p_matrix(rowno, rowno) += 1.0;
+      p_matrix(p_matrix.NumRows(), rowno) = m_values[0] - m_values[j];
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 //               StrategicQREPathTracer: Criterion function
 //----------------------------------------------------------------------------
@@ -216,24 +413,57 @@ StrategicQREPathTracer::CallbackFunction::operator()(const Vector<double> &p_poi
   m_profiles.push_back(LogitQREMixedStrategyProfile(profile, p_point.back(), 0.0));
 }
 
+// Passes the points of a symmetric system to a callback on the full one
+class StrategicQREPathTracer::SymmetricCallbackFunction : public PathTracer::CallbackFunction {
+public:
+  SymmetricCallbackFunction(const SymmetricEquationSystem &p_system,
+                            const PathTracer::CallbackFunction &p_callback)
+    : m_system(p_system), m_callback(p_callback) { }
+  ~SymmetricCallbackFunction() override = default;
+
+  void operator()(const Vector<double> &p_point, bool p_isTerminal) const override
+  { m_callback(m_system.Expand(p_point), p_isTerminal); }
+
+private:
+  const SymmetricEquationSystem &m_system;
+  const PathTracer::CallbackFunction &m_callback;
+};
+
 //----------------------------------------------------------------------------
 //               StrategicQREPathTracer: Main driver routines
 //----------------------------------------------------------------------------
 
-List<LogitQREMixedStrategyProfile>
-StrategicQREPathTracer::TraceStrategicPath(const LogitQREMixedStrategyProfile &p_start,
-					   std::ostream &p_stream,
-					   double p_maxLambda, 
-					   double p_omega) const
+void
+StrategicQREPathTracer::TraceFrom(const LogitQREMixedStrategyProfile &p_start,
+                                  double p_maxLambda, double p_omega,
+                                  const PathTracer::CallbackFunction &p_callback,
+                                  const PathTracer::CriterionFunction &p_criterion) const
 {
   Vector<double> x(p_start.MixedProfileLength() + 1);
   for (int i = 1; i <= p_start.MixedProfileLength(); i++) {
     x[i] = log(p_start[i]);
   }
   x[x.Length()] = p_start.GetLambda();
+  if (SymmetricEquationSystem::IsApplicable(p_start.GetProfile())) {
+    SymmetricEquationSystem system(p_start.GetGame());
+    Vector<double> y = system.Reduce(x);
+    TracePath(system, y, p_maxLambda, p_omega,
+              SymmetricCallbackFunction(system, p_callback), p_criterion);
+  }
+  else {
+    TracePath(EquationSystem(p_start.GetGame()),
+              x, p_maxLambda, p_omega, p_callback, p_criterion);
+  }
+}
+
+List<LogitQREMixedStrategyProfile>
+StrategicQREPathTracer::TraceStrategicPath(const LogitQREMixedStrategyProfile &p_start,
+					   std::ostream &p_stream,
+					   double p_maxLambda, 
+					   double p_omega) const
+{
   CallbackFunction func(p_stream, p_start.GetGame(), m_fullGraph, m_decimals);
-  TracePath(EquationSystem(p_start.GetGame()),
-	    x, p_maxLambda, p_omega, func);
+  TraceFrom(p_start, p_maxLambda, p_omega, func, NullCriterionFunction());
   return func.GetProfiles();
 }
 
@@ -242,16 +472,9 @@ StrategicQREPathTracer::SolveAtLambda(const LogitQREMixedStrategyProfile &p_star
 				      std::ostream &p_stream,
 				      double p_targetLambda, double p_omega) const
 {
-  Vector<double> x(p_start.MixedProfileLength() + 1);
-  for (int i = 1; i <= p_start.MixedProfileLength(); i++) {
-    x[i] = log(p_start[i]);
-  }
-  x[x.Length()] = p_start.GetLambda();
   CallbackFunction func(p_stream, p_start.GetGame(), m_fullGraph, m_decimals);
-  TracePath(EquationSystem(p_start.GetGame()),
-	    x, std::max(1.0, 3.0*p_targetLambda), p_omega,
-	    func,
-	    LambdaCriterion(p_targetLambda));
+  TraceFrom(p_start, std::max(1.0, 3.0*p_targetLambda), p_omega,
+            func, LambdaCriterion(p_targetLambda));
   return func.GetProfiles().back();
 }
 
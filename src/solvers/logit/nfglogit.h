@@ -85,8 +85,17 @@ protected:
   int m_decimals;
 
   class EquationSystem;
+  class SymmetricEquationSystem;
   class LambdaCriterion;
   class CallbackFunction;
+  class SymmetricCallbackFunction;
+
+  // Traces the branch from p_start with the smallest system of equations
+  // which describes it, passing points of the full system to p_callback
+  void TraceFrom(const LogitQREMixedStrategyProfile &p_start,
+                 double p_maxLambda, double p_omega,
+                 const PathTracer::CallbackFunction &p_callback,
+                 const PathTracer::CriterionFunction &p_criterion) const;
 };
 
 
@@ -22,92 +22,198 @@
 
 #include <cmath>
 #include <algorithm>   // for std::max
+#include <memory>
 
 #include "gambit.h"
-#include "core/sqmatrix.h"
+#include "linalg.h"
 #include "path.h"
 
 namespace Gambit {
 
 //----------------------------------------------------------------------------
-//                       PathTracer: Auxiliary functions
+//                       PathTracer: Auxiliary classes
 //----------------------------------------------------------------------------
 
 namespace {
-  
-inline double sqr(double x) { return x*x; }
 
-void Givens(Matrix<double> &b, Matrix<double> &q,
-            double &c1, double &c2, int l1, int l2, int l3)
-{
-  if (fabs(c1) + fabs(c2) == 0.0) {
-    return;
-  }
+//
+// The linear algebra of the tracer: the Jacobian J at the current point,
+// the unit tangent spanning its kernel, and the least-norm solutions of
+// J x = y for the corrector.  J has one fewer row than columns.
+//
+class JacobianSolver {
+public:
+  virtual ~JacobianSolver() = default;
+
+  // Computes and factors the Jacobian at the point.  The tangent at a
+  // nearby point is passed, which some solvers use as a reference.
+  virtual void Factor(const Vector<double> &p_point,
+                      const Vector<double> &p_tangent) = 0;
+  // Updates the factored Jacobian at p_x to approximate that at p_u.
+  // Returns false if the solver does not support updating.
+  virtual bool Update(const Vector<double> &p_x, const Vector<double> &p_u)
+  { return false; }
+  // Returns the tangent, oriented so that the determinant of the
+  // Jacobian, with the tangent appended as a row, is positive
+  virtual void GetTangent(Vector<double> &p_tangent) const = 0;
+  // Computes the least-norm solution of J x = y, and returns its norm
+  virtual double Solve(const Vector<double> &p_y, Vector<double> &p_x) const = 0;
+};
 
-  double sn;
-  if (fabs(c2) >= fabs(c1)) {
-    sn = std::sqrt(1.0 + sqr(c1/c2)) * fabs(c2);
-  }
-  else {
-    sn = std::sqrt(1.0 + sqr(c2/c1)) * fabs(c1);
-  }
-  double s1 = c1/sn;
-  double s2 = c2/sn;
-
-  for (int k = 1; k <= q.NumColumns(); k++) {
-    double sv1 = q(l1, k);
-    double sv2 = q(l2, k);
-    q(l1, k) = s1 * sv1 + s2 * sv2;
-    q(l2, k) = -s2 * sv1 + s1 * sv2;
+//
+// Works with the dense Jacobian, using the QR decomposition of its
+// transpose.  This can be updated along a step by a rank-one (Broyden)
+// update, J + (F(u) - F(x) - J d) d^T / (d^T d), with d = u - x.
+//
+class DenseJacobianSolver : public JacobianSolver {
+public:
+  DenseJacobianSolver(const PathTracer::EquationSystem &p_system, int p_size)
+    : m_system(p_system), m_jacobian(p_size, p_size - 1), m_qr(p_size, p_size - 1)
+  { }
+  ~DenseJacobianSolver() override = default;
+
+  void Factor(const Vector<double> &p_point, const Vector<double> &) override
+  {
+    m_system.GetJacobian(p_point, m_jacobian);
+    m_qr.Factor(m_jacobian);
   }
-
-  for (int k = l3; k <= b.NumColumns(); k++) {
-    double sv1 = b(l1, k);
-    double sv2 = b(l2, k);
-    b(l1, k) = s1 * sv1 + s2 * sv2;
-    b(l2, k) = -s2 * sv1 + s1 * sv2;
+  bool Update(const Vector<double> &p_x, const Vector<double> &p_u) override
+  {
+    int n = m_jacobian.NumColumns();
+    Vector<double> fx(n), fu(n), jd(n);
+    m_system.GetValue(p_x, fx);
+    m_system.GetValue(p_u, fu);
+    Vector<double> d(p_u - p_x);
+    m_qr.MultiplyTranspose(d, jd);
+    m_qr.Update(d, (fu - fx - jd) / (d * d));
+    return true;
   }
+  void GetTangent(Vector<double> &p_tangent) const override
+  { m_qr.GetKernel(p_tangent); }
+  double Solve(const Vector<double> &p_y, Vector<double> &p_x) const override
+  { return m_qr.SolveTranspose(p_y, p_x); }
 
-  c1 = sn;
-  c2 = 0.0;
-}
+private:
+  const PathTracer::EquationSystem &m_system;
+  Matrix<double> m_jacobian;
+  QRDecomposition m_qr;
+};
 
-void QRDecomp(Matrix<double> &b, Matrix<double> &q)
+//
+// Works with the sparse Jacobian, using the LU decomposition of the
+// square matrix obtained by appending the reference tangent r as a row,
+// as in Allgower and Georg.  Solving with this matrix for the last unit
+// vector gives a vector in the kernel of J, and, if [J; r^T] x = [y; 0],
+// then J x = y; the least-norm solution is the projection of x onto the
+// complement of the kernel.  The sign of the determinant is that of the
+// same matrix with the tangent in place of r, and so gives the
+// orientation.
+//
+class SparseJacobianSolver : public JacobianSolver {
+public:
+  SparseJacobianSolver(const PathTracer::EquationSystem &p_system,
+                       const SparseMatrix &p_pattern);
+  ~SparseJacobianSolver() override = default;
+
+  void Factor(const Vector<double> &p_point,
+              const Vector<double> &p_tangent) override;
+  void GetTangent(Vector<double> &p_tangent) const override
+  { p_tangent = m_tangent; }
+  double Solve(const Vector<double> &p_y, Vector<double> &p_x) const override;
+
+private:
+  const PathTracer::EquationSystem &m_system;
+  // The Jacobian, with the variables as rows, as in GetJacobian
+  SparseMatrix m_jacobian;
+  // The augmented matrix; m_position gives the position in it of each
+  // entry of m_jacobian, and m_last that of the last row in each column
+  SparseMatrix m_augmented;
+  std::vector<int> m_position, m_last;
+  SparseLUDecomposition m_lu;
+  Vector<double> m_tangent;
+};
+
+SparseJacobianSolver::SparseJacobianSolver(const PathTracer::EquationSystem &p_system,
+                                           const SparseMatrix &p_pattern)
+  : m_system(p_system), m_jacobian(p_pattern),
+    m_position(p_pattern.NumNonzeros()), m_last(p_pattern.NumRows()),
+    m_tangent(p_pattern.NumRows())
 {
-  q.MakeIdent();
-  for (int m = 1; m <= b.NumColumns(); m++) {
-    for (int k = m + 1; k <= b.NumRows(); k++) {
-      Givens(b, q, b(m, m), b(k, m), m, k, m + 1);
+  // Column i of the augmented matrix has the entries of row i of the
+  // Jacobian, in the order of its columns, followed by the last row
+  int n = m_jacobian.NumRows();
+  std::vector<std::vector<int> > positions(n);
+  for (int j = 0; j < m_jacobian.NumColumns(); j++) {
+    for (int p = m_jacobian.ColumnStart(j); p < m_jacobian.ColumnStart(j + 1); p++) {
+      positions[m_jacobian.RowIndex(p)].push_back(p);
+    }
+  }
+  m_augmented = SparseMatrix(n);
+  for (int i = 0; i < n; i++) {
+    int j = 0;
+    for (int p : positions[i]) {
+      while (m_jacobian.ColumnStart(j + 1) <= p) {
+        j++;
+      }
+      m_position[p] = m_augmented.NumNonzeros();
+      m_augmented.AddEntry(j);
     }
+    m_last[i] = m_augmented.NumNonzeros();
+    m_augmented.AddEntry(n - 1);
+    m_augmented.EndColumn();
   }
 }
 
-void NewtonStep(Matrix<double> &q, Matrix<double> &b,
-                Vector<double> &u, Vector<double> &y,
-		double &d)
+void SparseJacobianSolver::Factor(const Vector<double> &p_point,
+                                  const Vector<double> &p_tangent)
 {
-  for (int k = 1; k <= b.NumColumns(); k++) {
-    for (int l = 1; l <= k - 1; l++) {
-      y[k] -= b(l, k) * y[l];
-    }
-    y[k] /= b(k, k);
+  int n = m_jacobian.NumRows();
+  m_system.GetSparseJacobian(p_point, m_jacobian);
+  for (int p = 0; p < m_jacobian.NumNonzeros(); p++) {
+    m_augmented.Value(m_position[p]) = m_jacobian.Value(p);
+  }
+  for (int i = 0; i < n; i++) {
+    m_augmented.Value(m_last[i]) = p_tangent[i + 1];
+  }
+  m_lu.Factor(m_augmented);
+
+  std::vector<double> v(n, 0.0);
+  v[n - 1] = 1.0;
+  m_lu.Solve(v);
+  double norm = 0.0;
+  for (int i = 0; i < n; i++) {
+    norm += v[i] * v[i];
   }
+  norm = m_lu.GetDeterminantSign() * std::sqrt(norm);
+  for (int i = 0; i < n; i++) {
+    m_tangent[i + 1] = v[i] / norm;
+  }
+}
 
-  d = 0.0;
-  for (int k = 1; k <= b.NumRows(); k++) {
-    double s = 0.0;
-    for (int l = 1; l <= b.NumColumns(); l++) {
-      s += q(l, k) * y[l];
-    }
-    u[k] -= s;
-    d += s * s;
+double SparseJacobianSolver::Solve(const Vector<double> &p_y,
+                                   Vector<double> &p_x) const
+{
+  int n = m_jacobian.NumRows();
+  std::vector<double> v(n);
+  for (int i = 0; i < n - 1; i++) {
+    v[i] = p_y[i + 1];
   }
-  d = std::sqrt(d);
+  v[n - 1] = 0.0;
+  m_lu.Solve(v);
+  double proj = 0.0;
+  for (int i = 0; i < n; i++) {
+    proj += v[i] * m_tangent[i + 1];
+  }
+  double norm = 0.0;
+  for (int i = 0; i < n; i++) {
+    p_x[i + 1] = v[i] - proj * m_tangent[i + 1];
+    norm += p_x[i + 1] * p_x[i + 1];
+  }
+  return std::sqrt(norm);
 }
 
 }   // end anonymous namespace
 
-
 //----------------------------------------------------------------------------
 //             PathTracer: Implementation of path-following engine
 //----------------------------------------------------------------------------
@@ -133,14 +239,22 @@ PathTracer::TracePath(const EquationSystem &p_system,
   Vector<double> u(x.Length()), restart(x.Length());
   // t is current tangent at x; newT is tangent at u, which is the next point.
   Vector<double> t(x.Length()), newT(x.Length());
-  Vector<double> y(x.Length() - 1);
-  Matrix<double> b(x.Length(), x.Length() - 1);
-  SquareMatrix<double> q(x.Length());
+  Vector<double> y(x.Length() - 1), dx(x.Length());
+  std::unique_ptr<JacobianSolver> solver;
+  SparseMatrix pattern;
+  if (p_system.GetJacobianPattern(pattern)) {
+    solver.reset(new SparseJacobianSolver(p_system, pattern));
+  }
+  else {
+    solver.reset(new DenseJacobianSolver(p_system, x.Length()));
+  }
 
   p_callback(x, false);
-  p_system.GetJacobian(x, b);
-  QRDecomp(b, q);
-  q.GetRow(q.NumRows(), t);
+  // At the start, the direction of increasing lambda serves as reference
+  t = 0.0;
+  t[t.Length()] = 1.0;
+  solver->Factor(x, t);
+  solver->GetTangent(t);
   
   while (x[x.Length()] >= 0.0 && x[x.Length()] < p_maxLambda) {
     bool accept = true;
@@ -159,16 +273,16 @@ PathTracer::TracePath(const EquationSystem &p_system,
     }
 
     double decel = 1.0 / m_maxDecel;  // initialize deceleration factor
-    p_system.GetJacobian(u, b);
-    QRDecomp(b, q);
+    if (fabs(h) > m_maxUpdate || !solver->Update(x, u)) {
+      solver->Factor(u, t);
+    }
 
     int iter = 1;
     double disto = 0.0;
     while (true) {
-      double dist;
-
       p_system.GetValue(u, y);
-      NewtonStep(q, b, u, y, dist); 
+      double dist = solver->Solve(y, dx);
+      u -= dx;
 
       if (dist >= c_maxDist) {
 	accept = false;
@@ -221,7 +335,7 @@ PathTracer::TracePath(const EquationSystem &p_system,
     }
 
     // Obtain the tangent at the next step
-    q.GetRow(q.NumRows(), newT); 
+    solver->GetTangent(newT);
 
     // If we are at a bifurcation point, the orientation of the tangent
     // will flip.  This will confuse many criterion functions, especially
@@ -25,6 +25,8 @@
 
 namespace Gambit {
 
+class SparseMatrix;
+
 //
 // This class implements a generic path-following algorithm for smooth curves.
 // It is based on the ideas and codes presented in Allgower and Georg's
@@ -44,6 +46,16 @@ public:
     // Compute the Jacobian matrix at the specified point.
     virtual void GetJacobian(const Vector<double> &p_point,
 			     Matrix<double> &p_matrix) const = 0;
+
+    // Systems whose Jacobian is sparse may also provide it in sparse
+    // form, with the same layout of rows and columns.  If so,
+    // GetJacobianPattern builds the pattern of entries which may be
+    // nonzero and returns true; this is called once, and the tracer then
+    // uses GetSparseJacobian to fill in the values at each point.
+    virtual bool GetJacobianPattern(SparseMatrix &p_matrix) const
+    { return false; }
+    virtual void GetSparseJacobian(const Vector<double> &p_point,
+				   SparseMatrix &p_matrix) const { }
   };
 
   //
@@ -94,8 +106,14 @@ public:
   void SetStepsize(double p_hStart) { m_hStart = p_hStart; }
   double GetStepsize() const { return m_hStart; }
 
+  // Predictor steps no longer than this update the decomposition of the
+  // Jacobian by a rank-one (Broyden) update, instead of computing and
+  // factoring it anew.  The default of zero always refactors.
+  void SetMaxUpdateStep(double p_maxUpdate) { m_maxUpdate = p_maxUpdate; }
+  double GetMaxUpdateStep() const { return m_maxUpdate; }
+
 protected:
-  PathTracer() : m_maxDecel(1.1), m_hStart(0.03)
+  PathTracer() : m_maxDecel(1.1), m_hStart(0.03), m_maxUpdate(0.0)
     { } 
   virtual ~PathTracer() = default;
 
@@ -105,7 +123,7 @@ protected:
 		 const CriterionFunction &p_criterion = NullCriterionFunction()) const;
 
 private:
-  double m_maxDecel, m_hStart;
+  double m_maxDecel, m_hStart, m_maxUpdate;
 };
 
 }  // end namespace Gambit
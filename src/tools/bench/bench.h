@@ -0,0 +1,97 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/bench.h
+// Minimal support for the benchmark programs run by 'make bench'
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_TOOLS_BENCH_BENCH_H
+#define GAMBIT_TOOLS_BENCH_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include "gambit.h"
+
+//
+// Each benchmark program is a main() which times a few operations on
+// games it generates itself, and prints one line per measurement.
+// Generators are seeded with a constant, so every run times the same
+// games.  Timings are wall clock, in milliseconds.
+//
+
+namespace Gambit {
+namespace Bench {
+
+/// Returns the time taken by p_op, in milliseconds
+template <class F> double Time(F p_op)
+{
+  auto start = std::chrono::steady_clock::now();
+  p_op();
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/// Returns the time per call of p_op, in milliseconds, over p_reps calls
+template <class F> double TimePerCall(int p_reps, F p_op)
+{
+  return Time([&]() { for (int i = 0; i < p_reps; i++) p_op(); }) / p_reps;
+}
+
+inline void Report(const std::string &p_name, double p_ms)
+{
+  std::printf("%-40s %12.3f ms\n", p_name.c_str(), p_ms);
+  std::fflush(stdout);
+}
+
+inline std::mt19937 &Generator()
+{
+  static std::mt19937 generator(20230101);
+  return generator;
+}
+
+/// A table of the given dimensions, each payoff an integer drawn
+/// uniformly from [0, p_max]
+inline Game RandomTable(const Array<int> &p_dim, int p_max = 99)
+{
+  Game game = NewTable(p_dim);
+  std::uniform_int_distribution<int> payoff(0, p_max);
+  for (int i = 1; i <= game->NumOutcomes(); i++) {
+    for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+      game->GetOutcome(i)->SetPayoff(pl, Number(Rational(payoff(Generator()))));
+    }
+  }
+  return game;
+}
+
+/// A name for a game of the given dimensions, such as "10x10x10"
+inline std::string Dimensions(const Array<int> &p_dim)
+{
+  std::string name;
+  for (int pl = 1; pl <= p_dim.Length(); pl++) {
+    name += ((pl > 1) ? "x" : "") + lexical_cast<std::string>(p_dim[pl]);
+  }
+  return name;
+}
+
+}  // end namespace Gambit::Bench
+}  // end namespace Gambit
+
+#endif // GAMBIT_TOOLS_BENCH_BENCH_H
@@ -0,0 +1,91 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/bench_copy.cc
+// Benchmark of copying games, against writing them out and reading them back
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "bench.h"
+
+using namespace Gambit;
+
+namespace {
+
+// Copies the game by writing it in binary format and reading it back
+Game RoundTrip(const Game &p_game)
+{
+  std::ostringstream s;
+  WriteBinaryGame(s, p_game);
+  std::string data = s.str();
+  return ReadBinaryGame(data.data(), data.size());
+}
+
+// Writes, in .efg format, a complete binary tree of the given depth,
+// with a new information set at each node; the two players move
+// alternately
+void WriteTree(std::ostream &p_file, int p_depth, Array<int> &p_infosets, int &p_outcomes)
+{
+  if (p_depth == 0) {
+    std::uniform_int_distribution<int> payoff(0, 99);
+    p_file << "t \"\" " << ++p_outcomes << " \"\" { " << payoff(Bench::Generator())
+           << " " << payoff(Bench::Generator()) << " }\n";
+    return;
+  }
+  int pl = p_depth % 2 + 1;
+  p_file << "p \"\" " << pl << " " << ++p_infosets[pl] << " \"\" { \"L\" \"R\" } 0\n";
+  for (int i = 1; i <= 2; i++) {
+    WriteTree(p_file, p_depth - 1, p_infosets, p_outcomes);
+  }
+}
+
+// The tree is read from text, which is much faster than building it
+// move by move
+Game RandomTree(int p_depth)
+{
+  std::stringstream file;
+  file << "EFG 2 R \"\" { \"1\" \"2\" }\n";
+  Array<int> infosets(2);
+  infosets[1] = infosets[2] = 0;
+  int outcomes = 0;
+  WriteTree(file, p_depth, infosets, outcomes);
+  return ReadGame(file);
+}
+
+void BenchCopy(const std::string &p_name, const Game &p_game, int p_reps)
+{
+  Bench::Report(p_name + " write+read binary",
+                Bench::TimePerCall(p_reps, [&]() { RoundTrip(p_game); }));
+  Bench::Report(p_name + " Copy()",
+                Bench::TimePerCall(p_reps, [&]() { p_game->Copy(); }));
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  for (int n : { 10, 20, 40 }) {
+    Array<int> dim(3);
+    for (int pl = 1; pl <= 3; pl++) dim[pl] = n;
+    BenchCopy("table " + Bench::Dimensions(dim), Bench::RandomTable(dim), (n < 40) ? 10 : 2);
+  }
+  for (int depth : { 8, 10, 12, 14 }) {
+    BenchCopy("tree depth " + lexical_cast<std::string>(depth), RandomTree(depth),
+              (depth < 14) ? 10 : 1);
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/bench_lcp.cc
+// Benchmark of enumerating equilibria by Lemke-Howson paths
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "bench.h"
+#include "solvers/lcp/lcp.h"
+
+using namespace Gambit;
+using namespace Gambit::Nash;
+
+namespace {
+
+// The n x n coordination game, in which both players get 1 if they
+// choose the same strategy and 0 otherwise.  It has 2^n - 1 equilibria,
+// one on each nonempty set of strategies, and following paths from the
+// first one with no limit on depth reaches all of them.
+Game Coordination(int p_n)
+{
+  Array<int> dim(2);
+  dim[1] = dim[2] = p_n;
+  Game game = NewTable(dim);
+  PureStrategyProfile profile = game->NewPureStrategyProfile();
+  for (int st1 = 1; st1 <= p_n; st1++) {
+    for (int st2 = 1; st2 <= p_n; st2++) {
+      profile->SetStrategy(game->GetPlayer(1)->GetStrategy(st1));
+      profile->SetStrategy(game->GetPlayer(2)->GetStrategy(st2));
+      for (int pl = 1; pl <= 2; pl++) {
+        profile->GetOutcome()->SetPayoff(pl, Number(Rational((st1 == st2) ? 1 : 0)));
+      }
+    }
+  }
+  return game;
+}
+
+template <class T> void BenchLcp(const std::string &p_type, int p_n)
+{
+  Game game = Coordination(p_n);
+  int found = 0;
+  double ms = Bench::Time([&]() {
+    found = NashLcpStrategySolver<T>(0, 0).Solve(game).size();
+  });
+  Bench::Report(Bench::Dimensions(game->NumStrategies()) + " " + p_type +
+                " (" + lexical_cast<std::string>(found) + " eqa)", ms);
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  for (int n : { 8, 9, 10, 11 }) {
+    BenchLcp<double>("double", n);
+  }
+  for (int n : { 8, 9, 10 }) {
+    BenchLcp<Rational>("rational", n);
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/bench_logit.cc
+// Benchmark of the payoff derivatives used by the strategic logit tracer
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "bench.h"
+#include "solvers/logit/nfglogit.h"
+
+using namespace Gambit;
+
+namespace {
+
+// The entries of the Jacobian the logit system needs, from one
+// GetPayoffDerivs() call per player
+void BatchedDerivs(const MixedStrategyProfile<double> &p_profile)
+{
+  int length = p_profile.MixedProfileLength();
+  double payoff;
+  Vector<double> deriv1(length);
+  Matrix<double> deriv2(1, length, 1, length);
+  for (int pl = 1; pl <= p_profile.GetGame()->NumPlayers(); pl++) {
+    p_profile.GetPayoffDerivs(pl, payoff, deriv1, deriv2);
+  }
+}
+
+// The same entries, one GetPayoffDeriv() call each
+void EntryDerivs(const MixedStrategyProfile<double> &p_profile)
+{
+  Game game = p_profile.GetGame();
+  double sum = 0.0;
+  for (auto player : game->GetPlayers()) {
+    int pl = player->GetNumber();
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      GameStrategy strategy = player->GetStrategy(st);
+      sum += p_profile.GetPayoffDeriv(pl, strategy);
+      for (auto other : game->GetPlayers()) {
+        if (other == player) continue;
+        for (int st2 = 1; st2 <= other->NumStrategies(); st2++) {
+          sum += p_profile.GetPayoffDeriv(pl, strategy, other->GetStrategy(st2));
+        }
+      }
+    }
+  }
+  volatile double sink = sum;
+  (void) sink;
+}
+
+void BenchTable(const Array<int> &p_dim)
+{
+  Game game = Bench::RandomTable(p_dim);
+  std::string name = Bench::Dimensions(p_dim);
+  MixedStrategyProfile<double> profile = game->NewMixedStrategyProfile(0.0);
+
+  Bench::Report(name + " derivatives, batched",
+                Bench::TimePerCall(100, [&]() { BatchedDerivs(profile); }));
+  Bench::Report(name + " derivatives, per entry",
+                Bench::TimePerCall(10, [&]() { EntryDerivs(profile); }));
+  Bench::Report(name + " logit trace",
+                Bench::Time([&]() { LogitStrategySolve(game); }));
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  Array<int> three(3), four(4);
+  for (int pl = 1; pl <= 3; pl++) three[pl] = 10;
+  for (int pl = 1; pl <= 4; pl++) four[pl] = 6;
+  BenchTable(three);
+  BenchTable(four);
+  return 0;
+}
@@ -0,0 +1,111 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/bench_rational.cc
+// Benchmark of rational arithmetic, on small and on large terms
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <vector>
+#include "bench.h"
+
+using namespace Gambit;
+
+namespace {
+
+const int Operands = 1000;
+
+// Numerators and denominators, before reduction to lowest terms
+template <class N> struct Terms {
+  std::vector<N> num, den;
+};
+
+// Terms with |n|, d <= 1000, held in longs
+Terms<long> SmallTerms()
+{
+  std::uniform_int_distribution<long> num(-1000, 1000), den(1, 1000);
+  Terms<long> terms;
+  for (int i = 0; i < Operands; i++) {
+    terms.num.push_back(num(Bench::Generator()));
+    terms.den.push_back(den(Bench::Generator()));
+  }
+  return terms;
+}
+
+// Terms of magnitude near 1000 * p_scale: p_scale times a small integer,
+// plus a small offset so that most pairs do not share p_scale as a factor
+Terms<Integer> LargeTerms(const Integer &p_scale)
+{
+  std::uniform_int_distribution<int> num(-1000, 1000), den(1, 1000);
+  Terms<Integer> terms;
+  for (int i = 0; i < Operands; i++) {
+    terms.num.push_back(p_scale * Integer(num(Bench::Generator())) +
+                        Integer(num(Bench::Generator())));
+    terms.den.push_back(p_scale * Integer(den(Bench::Generator())) +
+                        Integer(den(Bench::Generator())));
+  }
+  return terms;
+}
+
+template <class N>
+void BenchTerms(const std::string &p_name, const Terms<N> &p_terms, int p_operations)
+{
+  std::vector<Rational> x;
+  for (int i = 0; i < Operands; i++) {
+    x.emplace_back(p_terms.num[i], p_terms.den[i]);
+  }
+
+  std::string count = " (" + lexical_cast<std::string>(p_operations) + " ops)";
+  Rational sum(0);
+  Bench::Report(p_name + " add" + count, Bench::Time([&]() {
+    for (int i = 0; i < p_operations; i++) {
+      sum = x[i % Operands] + x[(i + 1) % Operands];
+    }
+  }));
+  Rational product(0);
+  Bench::Report(p_name + " mul" + count, Bench::Time([&]() {
+    for (int i = 0; i < p_operations; i++) {
+      product = x[i % Operands] * x[(i + 1) % Operands];
+    }
+  }));
+  int less = 0;
+  Bench::Report(p_name + " compare" + count, Bench::Time([&]() {
+    for (int i = 0; i < p_operations; i++) {
+      less += (x[i % Operands] < x[(i + 1) % Operands]);
+    }
+  }));
+  Rational value(0);
+  Bench::Report(p_name + " normalize" + count, Bench::Time([&]() {
+    for (int i = 0; i < p_operations; i++) {
+      value = Rational(p_terms.num[i % Operands], p_terms.den[(i + 1) % Operands]);
+    }
+  }));
+  volatile int sink = less + sign(sum) + sign(product) + sign(value);
+  (void) sink;
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  // Large terms take the Integer path, which is much slower, so fewer
+  // operations are done on them
+  BenchTerms("|n|, d <= 1000", SmallTerms(), 2000000);
+  BenchTerms("near 2^50", LargeTerms(Integer(1L << 40)), 100000);
+  BenchTerms("near 2^120", LargeTerms(Integer(1L << 55) * Integer(1L << 55)), 100000);
+  return 0;
+}
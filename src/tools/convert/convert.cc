@@ -48,6 +48,7 @@ void PrintHelp(char *progname)
   std::cerr << "  -O FORMAT        output file format (required):\n";
   std::cerr << "     FORMAT=html   convert to HTML\n";
   std::cerr << "     FORMAT=sgame  convert to LaTeX sgame style\n";
+  std::cerr << "     FORMAT=gbtb   convert to binary game format\n";
   std::cerr << "  -c PLAYER        the player to show on columns (default is 2)\n";
   std::cerr << "  -r PLAYER        the player to show on rows (default is 1)\n";
   std::cerr << "  -h               print this help message\n";
@@ -101,7 +102,7 @@ int main(int argc, char *argv[])
     std::cerr << argv[0] << ": Output format argument -O required.\n";
     return 1;
   }
-  else if (format != "sgame" && format != "html") {
+  else if (format != "sgame" && format != "html" && format != "gbtb") {
     std::cerr << argv[0] << ": Unknown output format '" << format << "'.\n";
     return 1;
   }
@@ -136,7 +137,10 @@ int main(int argc, char *argv[])
       return 1;
     }
 
-    if (format == "html") {
+    if (format == "gbtb") {
+      game->Write(std::cout, "gbtb");
+    }
+    else if (format == "html") {
       Gambit::HTMLGameWriter writer;
       std::cout << writer.Write(game, rowPlayer, colPlayer);
     }
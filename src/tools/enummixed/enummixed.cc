@@ -65,6 +65,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -D               don't eliminate dominated strategies first\n";
   std::cerr << "  -L               use lrslib for enumeration (experimental!)\n";
   std::cerr << "  -c               output connectedness information\n";
+  std::cerr << "  -j THREADS       number of threads to use (default is 1;\n";
+  std::cerr << "                   0 uses all processors; not with -L)\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -76,7 +78,7 @@ int main(int argc, char *argv[])
   int c;
   bool useFloat = false, uselrs = false, quiet = false, eliminate = true;
   bool showConnect = false;
-  int numDecimals = 6;
+  int numDecimals = 6, numThreads = 1;
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -84,7 +86,7 @@ int main(int argc, char *argv[])
     { "version", 0, nullptr, 'v'  },
     { nullptr,    0,    nullptr,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqcSL", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DvhqcSLj:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -104,6 +106,9 @@ int main(int argc, char *argv[])
     case 'c':
       showConnect = true;
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
     case 'S':
       break;
     case 'q':
@@ -150,7 +155,7 @@ int main(int argc, char *argv[])
       std::shared_ptr<StrategyProfileRenderer<double> > renderer(
         new MixedStrategyCSVRenderer<double>(std::cout, numDecimals)
       );
-      EnumMixedStrategySolver<double> solver(renderer);
+      EnumMixedStrategySolver<double> solver(renderer, numThreads);
       std::shared_ptr<EnumMixedStrategySolution<double> > solution =
 	solver.SolveDetailed(game);
       if (showConnect) {
@@ -161,7 +166,7 @@ int main(int argc, char *argv[])
     }
     else {
       std::shared_ptr<StrategyProfileRenderer<Rational> > renderer(new MixedStrategyCSVRenderer<Rational>(std::cout));
-      EnumMixedStrategySolver<Rational> solver(renderer);
+      EnumMixedStrategySolver<Rational> solver(renderer, numThreads);
       std::shared_ptr<EnumMixedStrategySolution<Rational> > solution =
 	solver.SolveDetailed(game);
       if (showConnect) {
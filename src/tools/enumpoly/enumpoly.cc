@@ -29,6 +29,7 @@
 
 int g_numDecimals = 6;
 bool g_verbose = false;
+int g_numThreads = 1;
 
 void PrintBanner(std::ostream &p_stream)
 {
@@ -49,6 +50,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -d DECIMALS      show equilibrium probabilities with DECIMALS digits\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -S               use strategic game\n";
+  std::cerr << "  -j THREADS       number of supports to solve at once (default is 1;\n";
+  std::cerr << "                   0 uses all processors; not with -H)\n";
   std::cerr << "  -H               use heuristic search method to optimize time\n";
   std::cerr << "                   to find first equilibrium (strategic games only)\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
@@ -76,7 +79,7 @@ int main(int argc, char *argv[])
     { nullptr,    0,    nullptr,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:hHSqvV", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:hHj:SqvV", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -89,6 +92,9 @@ int main(int argc, char *argv[])
     case 'H':
       useHeuristic = true;
       break;
+    case 'j':
+      g_numThreads = atoi(optarg);
+      break;
     case 'S':
       useStrategic = true;
       break;
@@ -129,7 +135,7 @@ int main(int argc, char *argv[])
   }
 
   try {
-    Gambit::Game game = Gambit::ReadGame(*input_stream);
+    Gambit::Game game = Gambit::ReadGame(*input_stream)->Freeze();
     if (!game->IsPerfectRecall()) {
       throw Gambit::UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
     }
@@ -52,6 +52,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -P               find only subgame-perfect equilibria\n";
   std::cerr << "  -e EQA           terminate after finding EQA equilibria\n";
   std::cerr << "                   (default is to find all accessible equilbria\n";
+  std::cerr << "  -j THREADS       number of threads to search with (default is 1;\n";
+  std::cerr << "                   0 uses all processors; strategic games only)\n";
   std::cerr << "  -r DEPTH         terminate recursion at DEPTH\n";
   std::cerr << "                   (only if number of equilibria sought is not 1)\n";
   std::cerr << "  -D               print detailed information about equilibria\n";
@@ -67,7 +69,7 @@ int main(int argc, char *argv[])
   int c;
   bool useFloat = false, useStrategic = false, bySubgames = false, quiet = false;
   bool printDetail = false;
-  int numDecimals = 6, stopAfter = 0, maxDepth = 0;
+  int numDecimals = 6, stopAfter = 0, maxDepth = 0, numThreads = 1;
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -75,7 +77,7 @@ int main(int argc, char *argv[])
     { "version", 0, nullptr, 'v'  },
     { nullptr,    0,    nullptr,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqSPe:r:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DvhqSPe:j:r:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -92,6 +94,9 @@ int main(int argc, char *argv[])
     case 'h':
       PrintHelp(argv[0]);
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
     case 'q':
       quiet = true;
       break;
@@ -146,7 +151,7 @@ int main(int argc, char *argv[])
           renderer = std::make_shared<MixedStrategyCSVRenderer<double>>(std::cout, numDecimals);
         }
         NashLcpStrategySolver<double> algorithm(stopAfter, maxDepth,
-                                                renderer);
+                                                renderer, numThreads);
         algorithm.Solve(game);
       }
       else {
@@ -158,7 +163,7 @@ int main(int argc, char *argv[])
           renderer = std::make_shared<MixedStrategyCSVRenderer<Rational>>(std::cout);
         }
         NashLcpStrategySolver<Rational> algorithm(stopAfter, maxDepth,
-                                                  renderer);
+                                                  renderer, numThreads);
         algorithm.Solve(game);
       }
     }
@@ -45,10 +45,16 @@ void PrintHelp(char *progname)
 
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      print probabilities with DECIMALS digits\n";
+  std::cerr << "  -e EQA           terminate after finding EQA equilibria\n";
+  std::cerr << "                   (default is to try all starting points)\n";
   std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -j THREADS       number of starting points to try at once (default is 1;\n";
+  std::cerr << "                   0 uses all processors)\n";
   std::cerr << "  -n COUNT         number of starting points to generate\n";
   std::cerr << "  -i MAXITER       maximum number of iterations per point (default is 100)\n";
   std::cerr << "  -s FILE          file containing starting points\n";
+  std::cerr << "  -u TOL           report only one of equilibria which agree to within TOL\n";
+  std::cerr << "                   in every probability (default is to report all)\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "                   (default is to only show equilibria)\n";
@@ -135,7 +141,8 @@ int main(int argc, char *argv[])
   int numTries = 10;
   int maxitsN = 100;
   int numDecimals = 6;
-  double tolN = 1.0e-10;
+  int numThreads = 1, stopAfter = 0;
+  double tolN = 1.0e-10, tolDistinct = -1.0;
   std::string startFile;
  
   int long_opt_index = 0;
@@ -146,7 +153,7 @@ int main(int argc, char *argv[])
     { nullptr,    0,    nullptr,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:i:s:hqVvS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:e:j:n:i:s:u:hqVvS", long_options, &long_opt_index)) != -1) {
     switch (c) {
       case 'v':
         PrintBanner(std::cerr);
@@ -154,6 +161,12 @@ int main(int argc, char *argv[])
       case 'd':
         numDecimals = atoi(optarg);
         break;
+      case 'e':
+        stopAfter = atoi(optarg);
+        break;
+      case 'j':
+        numThreads = atoi(optarg);
+        break;
       case 'n':
         numTries = atoi(optarg);
         break;
@@ -163,6 +176,9 @@ int main(int argc, char *argv[])
       case 's':
         startFile = optarg;
         break;
+      case 'u':
+        tolDistinct = atof(optarg);
+        break;
       case 'h':
         PrintHelp(argv[0]);
         break;
@@ -206,7 +222,7 @@ int main(int argc, char *argv[])
   }
 
   try {
-    Game game = ReadGame(*input_stream);
+    Game game = ReadGame(*input_stream)->Freeze();
     if (!game->IsTree() || useStrategic) {
       List<MixedStrategyProfile<double> > starts;
       if (!startFile.empty()) {
@@ -218,13 +234,11 @@ int main(int argc, char *argv[])
 	starts = RandomStrategyProfiles(game, numTries);
       }
 
-      for (int i = 1; i <= starts.size(); i++) {
-	std::shared_ptr<StrategyProfileRenderer<double> > renderer(
-      new MixedStrategyCSVRenderer<double>(std::cout, numDecimals)
-    );
-	NashLiapStrategySolver algorithm(maxitsN, verbose, renderer);
-	algorithm.Solve(starts[i]);
-      }
+      std::shared_ptr<StrategyProfileRenderer<double> > renderer(
+        new MixedStrategyCSVRenderer<double>(std::cout, numDecimals)
+      );
+      NashLiapStrategySolver algorithm(maxitsN, verbose, renderer);
+      algorithm.Solve(starts, numThreads, stopAfter, tolDistinct);
     }
     else {
       List<MixedBehaviorProfile<double> > starts;
@@ -237,13 +251,11 @@ int main(int argc, char *argv[])
 	starts = RandomBehaviorProfiles(game, numTries);
       }
 
-      for (int i = 1; i <= starts.size(); i++) {
-	std::shared_ptr<StrategyProfileRenderer<double> > renderer(
-      new BehavStrategyCSVRenderer<double>(std::cout, numDecimals)
-    );
-	NashLiapBehaviorSolver algorithm(maxitsN, verbose, renderer);
-	algorithm.Solve(starts[i]);
-      }
+      std::shared_ptr<StrategyProfileRenderer<double> > renderer(
+        new BehavStrategyCSVRenderer<double>(std::cout, numDecimals)
+      );
+      NashLiapBehaviorSolver algorithm(maxitsN, verbose, renderer);
+      algorithm.Solve(starts, numThreads, stopAfter, tolDistinct);
     }
     return 0;
   }
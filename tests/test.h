@@ -0,0 +1,114 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test.h
+// Minimal support for the unit test programs run by 'make check'
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_TESTS_TEST_H
+#define GAMBIT_TESTS_TEST_H
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "gambit.h"
+
+//
+// Each test program is a main() which calls GAMBIT_TEST for each of its
+// test functions, and returns Gambit::Test::Report().  A failed check
+// is reported with its location, and the test function carries on; an
+// exception escaping a test function fails that test.
+//
+
+namespace Gambit {
+namespace Test {
+
+inline int &Failures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+inline void Fail(const char *p_file, int p_line, const std::string &p_message)
+{
+  std::cerr << p_file << ":" << p_line << ": check failed: " << p_message << std::endl;
+  Failures()++;
+}
+
+template <class F> void Run(const char *p_name, F p_test)
+{
+  int before = Failures();
+  try {
+    p_test();
+  }
+  catch (std::exception &e) {
+    std::cerr << p_name << ": unexpected exception: " << e.what() << std::endl;
+    Failures()++;
+  }
+  std::cout << ((Failures() == before) ? "PASS: " : "FAIL: ") << p_name << std::endl;
+}
+
+inline int Report()
+{
+  return (Failures() == 0) ? 0 : 1;
+}
+
+/// Returns the path of a game file in contrib/games.  The test driver
+/// sets top_srcdir; otherwise the tests are run from the source tree.
+inline std::string GameFile(const std::string &p_name)
+{
+  const char *top = std::getenv("top_srcdir");
+  return std::string((top) ? top : ".") + "/contrib/games/" + p_name;
+}
+
+inline Game ReadGameFile(const std::string &p_name)
+{
+  return ReadGame(GameFile(p_name));
+}
+
+/// Returns the game written in its native text format
+inline std::string GameText(const Game &p_game)
+{
+  std::ostringstream s;
+  p_game->Write(s, "native");
+  return s.str();
+}
+
+}  // end namespace Gambit::Test
+}  // end namespace Gambit
+
+#define GAMBIT_TEST(f) Gambit::Test::Run(#f, f)
+
+#define GAMBIT_CHECK(cond) \
+  do { if (!(cond)) Gambit::Test::Fail(__FILE__, __LINE__, #cond); } while (0)
+
+#define GAMBIT_CHECK_THROWS(expr, exc) \
+  do { \
+    bool caught_ = false; \
+    try { expr; } \
+    catch (exc &) { caught_ = true; } \
+    catch (std::exception &e) { \
+      Gambit::Test::Fail(__FILE__, __LINE__, \
+                         std::string(#expr " threw another exception: ") + e.what()); \
+      caught_ = true; \
+    } \
+    if (!caught_) Gambit::Test::Fail(__FILE__, __LINE__, #expr " did not throw " #exc); \
+  } while (0)
+
+#endif  // GAMBIT_TESTS_TEST_H
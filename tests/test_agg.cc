@@ -0,0 +1,193 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test_agg.cc
+// Tests of exact evaluation of mixed profiles on action-graph games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include "test.h"
+
+using namespace Gambit;
+
+namespace {
+
+const double Tolerance = 1.0e-9;
+
+bool Close(const Rational &p_exact, double p_value)
+{
+  return std::fabs(static_cast<double>(p_exact) - p_value) <= Tolerance;
+}
+
+// A profile with no common denominator across players: strategy st of
+// player pl is played with probability proportional to pl + st
+template <class T> MixedStrategyProfile<T> Profile(const Game &p_game)
+{
+  MixedStrategyProfile<T> profile = p_game->NewMixedStrategyProfile(T(0));
+  for (auto player : p_game->GetPlayers()) {
+    int n = player->NumStrategies(), pl = player->GetNumber();
+    for (int st = 1; st <= n; st++) {
+      profile[player->GetStrategy(st)] = T(Rational(pl + st, n * pl + n * (n + 1) / 2));
+    }
+  }
+  return profile;
+}
+
+// The index of the strategy in a profile on the full support
+int Index(const GameStrategy &p_strategy)
+{
+  GamePlayer player = p_strategy->GetPlayer();
+  int index = p_strategy->GetNumber();
+  for (int pl = 1; pl < player->GetNumber(); pl++) {
+    index += player->GetGame()->GetPlayer(pl)->NumStrategies();
+  }
+  return index;
+}
+
+// The expected payoff, summed over all pure strategy profiles
+Rational ExpectedPayoff(const MixedStrategyProfile<Rational> &p_profile, int p_player)
+{
+  Game game = p_profile.GetGame();
+  Rational total(0);
+  for (StrategyProfileIterator iter{StrategySupportProfile(game)}; !iter.AtEnd(); iter++) {
+    Rational prob(1);
+    for (auto player : game->GetPlayers()) {
+      prob *= p_profile[(*iter)->GetStrategy(player)];
+    }
+    total += prob * (*iter)->GetPayoff(p_player);
+  }
+  return total;
+}
+
+// Each quantity computed in Rational agrees with the same quantity
+// computed in double
+void CheckDoublePath(const Game &p_game)
+{
+  MixedStrategyProfile<Rational> exact = Profile<Rational>(p_game);
+  MixedStrategyProfile<double> approx = Profile<double>(p_game);
+  int length = exact.MixedProfileLength();
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    GAMBIT_CHECK(Close(exact.GetPayoff(pl), approx.GetPayoff(pl)));
+    GamePlayer player = p_game->GetPlayer(pl);
+    Vector<Rational> values = exact.GetStrategyValues(player);
+    Vector<double> approxValues = approx.GetStrategyValues(player);
+    for (int st = 1; st <= values.Length(); st++) {
+      GAMBIT_CHECK(Close(values[st], approxValues[st]));
+    }
+
+    Rational payoff;
+    Vector<Rational> deriv1(length);
+    Matrix<Rational> deriv2(1, length, 1, length);
+    exact.GetPayoffDerivs(pl, payoff, deriv1, deriv2);
+    double approxPayoff;
+    Vector<double> approxDeriv1(length);
+    Matrix<double> approxDeriv2(1, length, 1, length);
+    approx.GetPayoffDerivs(pl, approxPayoff, approxDeriv1, approxDeriv2);
+    GAMBIT_CHECK(Close(payoff, approxPayoff));
+    for (int i = 1; i <= length; i++) {
+      GAMBIT_CHECK(Close(deriv1[i], approxDeriv1[i]));
+      for (int j = 1; j <= length; j++) {
+        GAMBIT_CHECK(Close(deriv2(i, j), approxDeriv2(i, j)));
+      }
+    }
+  }
+}
+
+// The quantities computed in Rational satisfy exactly the identities
+// which relate them, which values rounded through double generally do not
+void CheckExactIdentities(const Game &p_game)
+{
+  MixedStrategyProfile<Rational> profile = Profile<Rational>(p_game);
+  int length = profile.MixedProfileLength();
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    Rational payoff = profile.GetPayoff(pl);
+
+    Rational batchPayoff;
+    Vector<Rational> deriv1(length);
+    Matrix<Rational> deriv2(1, length, 1, length);
+    profile.GetPayoffDerivs(pl, batchPayoff, deriv1, deriv2);
+    GAMBIT_CHECK(batchPayoff == payoff);
+
+    for (auto player : p_game->GetPlayers()) {
+      // The payoff is linear in the strategy of each player
+      Rational sum(0);
+      for (int st = 1; st <= player->NumStrategies(); st++) {
+        GameStrategy strategy = player->GetStrategy(st);
+        Rational deriv = profile.GetPayoffDeriv(pl, strategy);
+        sum += profile[strategy] * deriv;
+        GAMBIT_CHECK(deriv1[Index(strategy)] == deriv);
+      }
+      GAMBIT_CHECK(sum == payoff);
+    }
+
+    GamePlayer player = p_game->GetPlayer(pl);
+    Vector<Rational> values = profile.GetStrategyValues(player);
+    for (int st = 1; st <= values.Length(); st++) {
+      GameStrategy strategy = player->GetStrategy(st);
+      GAMBIT_CHECK(values[st] == profile.GetPayoffDeriv(pl, strategy));
+      for (auto other : p_game->GetPlayers()) {
+        if (other == player) continue;
+        for (int st2 = 1; st2 <= other->NumStrategies(); st2++) {
+          GameStrategy strategy2 = other->GetStrategy(st2);
+          GAMBIT_CHECK(deriv2(Index(strategy), Index(strategy2)) ==
+                       profile.GetPayoffDeriv(pl, strategy, strategy2));
+        }
+      }
+    }
+  }
+}
+
+void TestAggExact()
+{
+  for (const char *file : { "2x2.agg", "GenRPS5.agg" }) {
+    Game game = Test::ReadGameFile(file);
+    MixedStrategyProfile<Rational> profile = Profile<Rational>(game);
+    for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+      GAMBIT_CHECK(profile.GetPayoff(pl) == ExpectedPayoff(profile, pl));
+    }
+    CheckExactIdentities(game);
+  }
+}
+
+void TestAggDoublePath()
+{
+  for (const char *file : { "2x2.agg", "GenRPS5.agg", "BSS_S_085.Weighted.agg" }) {
+    CheckDoublePath(Test::ReadGameFile(file));
+  }
+}
+
+void TestBaggExact()
+{
+  CheckExactIdentities(Test::ReadGameFile("Bayesian-Coffee-3-2-2-3.bagg"));
+}
+
+void TestBaggDoublePath()
+{
+  CheckDoublePath(Test::ReadGameFile("Bayesian-Coffee-3-2-2-3.bagg"));
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  GAMBIT_TEST(TestAggExact);
+  GAMBIT_TEST(TestAggDoublePath);
+  GAMBIT_TEST(TestBaggExact);
+  GAMBIT_TEST(TestBaggDoublePath);
+  return Test::Report();
+}
@@ -0,0 +1,130 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test_binfile.cc
+// Tests of reading and writing games in the binary format
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "test.h"
+#include "games/binfile.h"
+
+using namespace Gambit;
+
+namespace {
+
+std::string BinaryImage(const Game &p_game)
+{
+  std::ostringstream s;
+  WriteBinaryGame(s, p_game);
+  return s.str();
+}
+
+// Writes the game in binary format, reads it back, and checks that the
+// copy has the same text representation as the original
+void CheckRoundTrip(const std::string &p_file)
+{
+  Game game = Test::ReadGameFile(p_file);
+  std::string data = BinaryImage(game);
+  GAMBIT_CHECK(IsBinaryGame(data.data(), data.size()));
+
+  Game copy = ReadBinaryGame(data.data(), data.size());
+  GAMBIT_CHECK(copy->IsTree() == game->IsTree());
+  GAMBIT_CHECK(Test::GameText(copy) == Test::GameText(game));
+
+  // The stream reader recognises the format without being told
+  std::istringstream s(data);
+  GAMBIT_CHECK(Test::GameText(ReadGame(s)) == Test::GameText(game));
+}
+
+void TestTableRoundTrip()
+{
+  CheckRoundTrip("2x2x2.nfg");
+  CheckRoundTrip("coord333.nfg");
+  CheckRoundTrip("e02.nfg");
+}
+
+void TestTreeRoundTrip()
+{
+  CheckRoundTrip("e02.efg");
+  CheckRoundTrip("cent2.efg");
+  CheckRoundTrip("4cards.efg");
+}
+
+void TestRationalPayoffs()
+{
+  Array<int> dim(2);
+  dim[1] = dim[2] = 2;
+  Game game = NewTable(dim);
+  // 2^70 / 3 does not fit in 64 bits, and is read back from its text
+  Number big("1180591620717411303424/3"), small("-5/7");
+  for (int i = 1; i <= game->NumOutcomes(); i++) {
+    game->GetOutcome(i)->SetPayoff(1, (i % 2) ? big : small);
+    game->GetOutcome(i)->SetPayoff(2, Number("0.25"));
+  }
+  std::string data = BinaryImage(game);
+  Game copy = ReadBinaryGame(data.data(), data.size());
+  for (int i = 1; i <= game->NumOutcomes(); i++) {
+    GAMBIT_CHECK(static_cast<Rational>(copy->GetOutcome(i)->GetPayoff(1)) ==
+                 static_cast<Rational>(game->GetOutcome(i)->GetPayoff(1)));
+    GAMBIT_CHECK(static_cast<const std::string &>(copy->GetOutcome(i)->GetPayoff(2)) == "0.25");
+  }
+}
+
+// Every proper prefix of a binary file is rejected, by the in-memory
+// reader and by the stream reader
+void CheckTruncated(const std::string &p_file)
+{
+  std::string data = BinaryImage(Test::ReadGameFile(p_file));
+  for (size_t length = 0; length < data.size(); length++) {
+    GAMBIT_CHECK_THROWS(ReadBinaryGame(data.data(), length), InvalidFileException);
+  }
+  for (size_t length : { data.size() / 2, data.size() - 1 }) {
+    std::istringstream s(data.substr(0, length));
+    GAMBIT_CHECK_THROWS(ReadGame(s), InvalidFileException);
+  }
+}
+
+void TestTruncatedFile()
+{
+  CheckTruncated("2x2x2.nfg");
+  CheckTruncated("e02.efg");
+}
+
+void TestCorruptHeader()
+{
+  std::string data = BinaryImage(Test::ReadGameFile("e02.efg"));
+  // The game kind is the fifth word of the header
+  std::string corrupt = data;
+  corrupt[16] = 7;
+  GAMBIT_CHECK_THROWS(ReadBinaryGame(corrupt.data(), corrupt.size()), InvalidFileException);
+  corrupt = data;
+  corrupt[0] = 'x';
+  GAMBIT_CHECK_THROWS(ReadBinaryGame(corrupt.data(), corrupt.size()), InvalidFileException);
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  GAMBIT_TEST(TestTableRoundTrip);
+  GAMBIT_TEST(TestTreeRoundTrip);
+  GAMBIT_TEST(TestRationalPayoffs);
+  GAMBIT_TEST(TestTruncatedFile);
+  GAMBIT_TEST(TestCorruptHeader);
+  return Test::Report();
+}
@@ -0,0 +1,173 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test_copy.cc
+// Tests that copies of games are complete and independent of the original
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "test.h"
+#include "games/gametree.h"
+
+using namespace Gambit;
+
+namespace {
+
+// The game as it would be copied by writing it out and reading it back
+std::string ReparsedText(const Game &p_game)
+{
+  std::istringstream s(Test::GameText(p_game));
+  return Test::GameText(ReadGame(s));
+}
+
+// The copy has the text of the reparsed game, and shares no objects with
+// the original
+void CheckCopy(const Game &p_game, const Game &p_copy)
+{
+  GAMBIT_CHECK(p_copy != p_game);
+  GAMBIT_CHECK(p_copy->IsTree() == p_game->IsTree());
+  GAMBIT_CHECK(Test::GameText(p_copy) == ReparsedText(p_game));
+  for (int pl = 1; pl <= p_copy->NumPlayers(); pl++) {
+    GAMBIT_CHECK(p_copy->GetPlayer(pl)->GetGame() == p_copy);
+    for (int st = 1; st <= p_copy->GetPlayer(pl)->NumStrategies(); st++) {
+      GAMBIT_CHECK(p_copy->GetPlayer(pl)->GetStrategy(st) !=
+                   p_game->GetPlayer(pl)->GetStrategy(st));
+    }
+  }
+  for (int i = 1; i <= p_copy->NumOutcomes(); i++) {
+    GAMBIT_CHECK(p_copy->GetOutcome(i)->GetGame() == p_copy);
+  }
+}
+
+void TestCopyFiles()
+{
+  for (const char *file : { "e02.nfg", "2x2x2.nfg", "coord333.nfg", "csg1.nfg",
+                            "e02.efg", "cent2.efg", "4cards.efg", "bayes1a.efg",
+                            "badgame1.efg", "condjury.efg" }) {
+    Game game = Test::ReadGameFile(file);
+    CheckCopy(game, game->Copy());
+  }
+}
+
+void TestCopySubgames()
+{
+  for (const char *file : { "e02.efg", "cent2.efg", "4cards.efg" }) {
+    Game game = Test::ReadGameFile(file);
+    GameNode root = game->GetRoot();
+    for (int i = 1; i <= root->NumChildren(); i++) {
+      std::ostringstream s;
+      dynamic_cast<GameTreeRep &>(*game).WriteEfgFile(s, root->GetChild(i));
+      std::istringstream r(s.str());
+      Game subgame = root->GetChild(i)->CopySubgame();
+      GAMBIT_CHECK(Test::GameText(subgame) == Test::GameText(ReadGame(r)));
+    }
+  }
+}
+
+void TestTableIndependent()
+{
+  Game game = Test::ReadGameFile("2x2x2.nfg");
+  std::string original = Test::GameText(game);
+  MixedStrategyProfile<Rational> before = game->NewMixedStrategyProfile(Rational(0));
+  Rational payoff = before.GetPayoff(1);
+
+  Game copy = game->Copy();
+  copy->SetTitle("Copy");
+  copy->GetPlayer(1)->SetLabel("Copied player");
+  copy->GetPlayer(2)->GetStrategy(1)->SetLabel("Copied strategy");
+  copy->GetOutcome(1)->SetPayoff(1, Number("99"));
+  copy->GetOutcome(2)->SetLabel("Copied outcome");
+  copy->GetPlayer(3)->NewStrategy();
+  copy->NewPureStrategyProfile()->SetOutcome(nullptr);
+  copy->DeleteOutcome(copy->GetOutcome(3));
+
+  GAMBIT_CHECK(Test::GameText(game) == original);
+  GAMBIT_CHECK(game->GetPlayer(3)->NumStrategies() == 2);
+  GAMBIT_CHECK(before.GetPayoff(1) == payoff);
+  GAMBIT_CHECK(game->NewMixedStrategyProfile(Rational(0)).GetPayoff(1) == payoff);
+
+  // Changing the original leaves the copy alone
+  copy = game->Copy();
+  std::string copied = Test::GameText(copy);
+  game->GetOutcome(1)->SetPayoff(2, Number("-7"));
+  game->NewPlayer();
+  GAMBIT_CHECK(Test::GameText(copy) == copied);
+}
+
+void TestTreeIndependent()
+{
+  Game game = Test::ReadGameFile("cent2.efg");
+  std::string original = Test::GameText(game);
+  int nodes = game->NumNodes();
+
+  Game copy = game->Copy();
+  copy->GetRoot()->SetLabel("Copied root");
+  copy->GetOutcome(1)->SetPayoff(1, Number("99"));
+  copy->GetPlayer(1)->GetInfoset(1)->SetLabel("Copied infoset");
+  copy->GetPlayer(1)->GetInfoset(1)->GetAction(1)->SetLabel("Copied action");
+  GameInfoset chance = copy->GetChance()->GetInfoset(1);
+  Array<Number> probs(chance->NumActions());
+  for (int act = 1; act <= probs.Length(); act++) {
+    probs[act] = Rational(act, probs.Length() * (probs.Length() + 1) / 2);
+  }
+  copy->SetChanceProbs(chance, probs);
+  copy->GetRoot()->GetChild(1)->DeleteTree();
+  copy->NewPlayer();
+
+  GAMBIT_CHECK(Test::GameText(game) == original);
+  GAMBIT_CHECK(game->NumNodes() == nodes);
+  GAMBIT_CHECK(game->NumPlayers() == 2);
+
+  // Each node, information set and outcome of the copy belongs to it
+  copy = game->Copy();
+  GAMBIT_CHECK(copy->NumNodes() == nodes);
+  GAMBIT_CHECK(copy->GetRoot() != game->GetRoot());
+  GAMBIT_CHECK(copy->GetRoot()->GetGame() == copy);
+  GAMBIT_CHECK(copy->GetRoot()->GetInfoset()->GetGame() == copy);
+  GAMBIT_CHECK(copy->GetRoot()->GetInfoset()->GetPlayer() ==
+               copy->GetRoot()->GetInfoset()->GetPlayer()->GetGame()->GetChance());
+
+  // The sequence form of the copy is its own
+  MixedBehaviorProfile<Rational> profile(copy);
+  Rational payoff = profile.GetPayoff(1);
+  game->GetOutcome(1)->SetPayoff(1, Number("1000"));
+  GAMBIT_CHECK(MixedBehaviorProfile<Rational>(copy).GetPayoff(1) == payoff);
+}
+
+// A copy of a frozen game can be changed, and the original stays frozen
+void TestCopyFrozen()
+{
+  Game game = Test::ReadGameFile("e02.efg");
+  game->Freeze();
+  Game copy = game->Copy();
+  GAMBIT_CHECK(!copy->IsFrozen());
+  copy->GetOutcome(1)->SetPayoff(1, Number("5"));
+  GAMBIT_CHECK(game->IsFrozen());
+  GAMBIT_CHECK(static_cast<Rational>(game->GetOutcome(1)->GetPayoff(1)) == Rational(1));
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  GAMBIT_TEST(TestCopyFiles);
+  GAMBIT_TEST(TestCopySubgames);
+  GAMBIT_TEST(TestTableIndependent);
+  GAMBIT_TEST(TestTreeIndependent);
+  GAMBIT_TEST(TestCopyFrozen);
+  return Test::Report();
+}
@@ -0,0 +1,212 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test_file.cc
+// Tests of reading games in the .nfg and .efg formats
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <fstream>
+#include <iterator>
+#include "test.h"
+
+using namespace Gambit;
+
+namespace {
+
+Game ReadText(const std::string &p_text)
+{
+  std::istringstream s(p_text);
+  return ReadGame(s);
+}
+
+// Checks that reading the text fails, with a message containing p_message
+void CheckRejected(const std::string &p_text, const std::string &p_message)
+{
+  try {
+    ReadText(p_text);
+    Test::Fail(__FILE__, __LINE__, "accepted: " + p_text);
+  }
+  catch (InvalidFileException &e) {
+    if (std::string(e.what()).find(p_message) == std::string::npos) {
+      Test::Fail(__FILE__, __LINE__,
+                 "expected '" + p_message + "', got '" + e.what() + "'");
+    }
+  }
+}
+
+Rational Payoff(const Game &p_game, int p_outcome, int p_player)
+{
+  return static_cast<Rational>(p_game->GetOutcome(p_outcome)->GetPayoff(p_player));
+}
+
+const char *PayoffNfg =
+  "NFG 1 R \"Payoff form\" { \"Row\" \"Column\" } { 3 2 }\n"
+  "\"A comment\"\n"
+  "1 1 0 2 0 2 1 1 0 3 2 0\n";
+
+void TestPayoffForm()
+{
+  Game game = ReadText(PayoffNfg);
+  GAMBIT_CHECK(!game->IsTree());
+  GAMBIT_CHECK(game->GetTitle() == "Payoff form");
+  GAMBIT_CHECK(game->GetComment() == "A comment");
+  GAMBIT_CHECK(game->NumPlayers() == 2);
+  GAMBIT_CHECK(game->GetPlayer(2)->GetLabel() == "Column");
+  GAMBIT_CHECK(game->GetPlayer(1)->NumStrategies() == 3);
+  GAMBIT_CHECK(game->GetPlayer(2)->NumStrategies() == 2);
+  GAMBIT_CHECK(game->GetPlayer(1)->GetStrategy(3)->GetLabel() == "3");
+
+  // Player 1's strategy changes fastest
+  PureStrategyProfile profile = game->NewPureStrategyProfile();
+  profile->SetStrategy(game->GetPlayer(1)->GetStrategy(3));
+  profile->SetStrategy(game->GetPlayer(2)->GetStrategy(1));
+  GAMBIT_CHECK(profile->GetPayoff(1) == Rational(0));
+  GAMBIT_CHECK(profile->GetPayoff(2) == Rational(2));
+  profile->SetStrategy(game->GetPlayer(2)->GetStrategy(2));
+  GAMBIT_CHECK(profile->GetPayoff(1) == Rational(2));
+  GAMBIT_CHECK(profile->GetPayoff(2) == Rational(0));
+}
+
+void TestOutcomeForm()
+{
+  Game game = ReadText(
+    "NFG 1 R \"Outcome form\" { \"P1\" \"P2\" }\n"
+    "{ { \"U\" \"D\" } { \"L\" \"R\" } }\n"
+    "{ { \"win\" 1/2, -3/4 } { \"lose\" 0.25 2 } }\n"
+    "1 0 2 1\n");
+  GAMBIT_CHECK(game->GetPlayer(1)->GetStrategy(2)->GetLabel() == "D");
+  GAMBIT_CHECK(game->GetPlayer(2)->GetStrategy(1)->GetLabel() == "L");
+  GAMBIT_CHECK(game->GetOutcome(1)->GetLabel() == "win");
+  GAMBIT_CHECK(Payoff(game, 1, 1) == Rational(1, 2));
+  GAMBIT_CHECK(Payoff(game, 1, 2) == Rational(-3, 4));
+  GAMBIT_CHECK(Payoff(game, 2, 1) == Rational(1, 4));
+
+  PureStrategyProfile profile = game->NewPureStrategyProfile();
+  profile->SetStrategy(game->GetPlayer(1)->GetStrategy(2));
+  GAMBIT_CHECK(!profile->GetOutcome());
+  profile->SetStrategy(game->GetPlayer(2)->GetStrategy(2));
+  GAMBIT_CHECK(profile->GetOutcome() == game->GetOutcome(1));
+}
+
+void TestTree()
+{
+  Game game = Test::ReadGameFile("e02.efg");
+  GAMBIT_CHECK(game->IsTree());
+  GAMBIT_CHECK(game->GetTitle() == "Selten (IJGT, 75), Figure 2");
+  GAMBIT_CHECK(game->NumNodes() == 7);
+  GAMBIT_CHECK(game->GetPlayer(1)->NumInfosets() == 2);
+  GAMBIT_CHECK(game->GetRoot()->GetInfoset()->GetAction(2)->GetLabel() == "L");
+  GAMBIT_CHECK(game->GetOutcome(3)->GetLabel() == "Outcome 3");
+  GAMBIT_CHECK(Payoff(game, 3, 2) == Rational(3));
+
+  game = ReadText(
+    "EFG 2 R \"Chance\" { \"P\" }\n"
+    "c \"\" 1 \"\" { \"H\" 1/3 \"T\" 2/3 } 0\n"
+    "t \"\" 1 \"heads\" { 1.5 }\n"
+    "t \"\" 2 \"tails\" { -1 }\n");
+  GameInfoset chance = game->GetRoot()->GetInfoset();
+  GAMBIT_CHECK(chance->GetPlayer()->IsChance());
+  GAMBIT_CHECK(static_cast<Rational>(chance->GetActionProb(2)) == Rational(2, 3));
+  GAMBIT_CHECK(Payoff(game, 1, 1) == Rational(3, 2));
+}
+
+// Reading a game written out by Gambit gives back the same game
+void TestRoundTrip()
+{
+  for (const char *file : { "e02.nfg", "2x2x2.nfg", "coord333.nfg",
+                            "e02.efg", "cent2.efg", "4cards.efg" }) {
+    Game game = Test::ReadGameFile(file);
+    std::string text = Test::GameText(game);
+    GAMBIT_CHECK(Test::GameText(ReadText(text)) == text);
+  }
+}
+
+void TestLayout()
+{
+  std::string text = PayoffNfg;
+  std::string expected = Test::GameText(ReadText(text));
+  // Leading whitespace, and no newline at the end of a decimal payoff
+  GAMBIT_CHECK(Test::GameText(ReadText("\n \t" + text)) == expected);
+  Game game = ReadText("NFG 1 R \"\" { \"1\" \"2\" } { 1 1 }\n2.5 -0.125");
+  GAMBIT_CHECK(Payoff(game, 1, 1) == Rational(5, 2));
+  GAMBIT_CHECK(Payoff(game, 1, 2) == Rational(-1, 8));
+  game = ReadText("NFG 1 R \"\" { \"1\" \"2\" } { 1 1 }\n1e2 3");
+  GAMBIT_CHECK(Payoff(game, 1, 1) == Rational(100));
+}
+
+void TestErrors()
+{
+  CheckRejected("", "Expecting file type");
+  CheckRejected("GAME 1 R \"\"", "expected at start of file");
+  CheckRejected("NFG 2 R \"\" { \"1\" } { 1 }\n0", "Accepting only NFG version 1");
+  CheckRejected("NFG 1 X \"\" { \"1\" } { 1 }\n0", "Accepting only NFG D or R data type");
+  CheckRejected("NFG 1 R { \"1\" } { 1 }\n0", "Game title missing");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { 2 }\n0", "Players with strategies undefined");
+  CheckRejected("NFG 1 R \"\" { \"1\" } { 2 2 }\n0", "Not enough players");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { 1 1 }\n1 2 3", "Too many payoffs");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { 2 1 }\n1 2 3 4 5 6 7 8 9",
+                "Too many payoffs");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { 1 1 }\n1 x", "Expecting payoff");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { 1 1 }\n1 2e", "Invalid Token");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { { \"a\" } { \"b\" } }\n"
+                "{ { \"\" 1 2 3 } }\n1", "Exceeded number of players");
+  CheckRejected("NFG 1 R \"\" { \"1\" \"2\" } { { \"a\" } { \"b\" } }\n"
+                "{ { \"\" 1 } }\n1", "Insufficient number of players");
+  CheckRejected("EFG 3 R \"\" { \"1\" }\nt \"\" 0", "Accepting only EFG version 2");
+  CheckRejected("EFG 2 R \"\" { \"1\" }\nq \"\" 0", "Invalid type of node");
+  CheckRejected("EFG 2 R \"\" { \"1\" }\np \"\" 1 1 \"\" { \"a\" } 0\n"
+                "p \"\" 1 2 { \"b\" } 0\nt \"\" 0", "Referencing an undefined infoset");
+}
+
+// A file cut off inside its header, or before the tree is complete, is
+// rejected rather than read as a smaller game
+void TestTruncated()
+{
+  CheckRejected("NFG 1 R \"Title", "End of file encountered when reading string label");
+  CheckRejected("NFG 1 R \"Title\" { \"1\" \"2", "End of file");
+
+  std::string nfg = PayoffNfg;
+  size_t body = nfg.find("1 1 0");
+  for (size_t length = 0; length < body; length++) {
+    GAMBIT_CHECK_THROWS(ReadText(nfg.substr(0, length)), InvalidFileException);
+  }
+
+  std::ifstream file(Test::GameFile("e02.efg"));
+  std::string efg((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  // The last node ends with the closing brace of its payoffs
+  size_t end = efg.rfind('}');
+  GAMBIT_CHECK(end != std::string::npos);
+  for (size_t length = 0; length <= end; length++) {
+    GAMBIT_CHECK_THROWS(ReadText(efg.substr(0, length)), InvalidFileException);
+  }
+  GAMBIT_CHECK(ReadText(efg.substr(0, end + 1))->NumNodes() == 7);
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  GAMBIT_TEST(TestPayoffForm);
+  GAMBIT_TEST(TestOutcomeForm);
+  GAMBIT_TEST(TestTree);
+  GAMBIT_TEST(TestRoundTrip);
+  GAMBIT_TEST(TestLayout);
+  GAMBIT_TEST(TestErrors);
+  GAMBIT_TEST(TestTruncated);
+  return Test::Report();
+}
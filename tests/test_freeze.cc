@@ -0,0 +1,147 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test_freeze.cc
+// Tests that frozen games refuse changes and are left as they were
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "test.h"
+
+using namespace Gambit;
+
+namespace {
+
+// Checks that the change throws FrozenGameException, and that the game,
+// its strategies, and the payoffs of a mixed profile on it are unchanged
+template <class F> void CheckRefused(const Game &p_game, F p_change)
+{
+  std::string before = Test::GameText(p_game);
+  Array<int> strategies = p_game->NumStrategies();
+  MixedStrategyProfile<Rational> profile = p_game->NewMixedStrategyProfile(Rational(0));
+  Rational payoff = profile.GetPayoff(1);
+
+  GAMBIT_CHECK_THROWS(p_change(), FrozenGameException);
+
+  GAMBIT_CHECK(Test::GameText(p_game) == before);
+  GAMBIT_CHECK(p_game->NumStrategies() == strategies);
+  GAMBIT_CHECK(profile.GetPayoff(1) == payoff);
+}
+
+void TestFreezeTable()
+{
+  Game game = Test::ReadGameFile("2x2x2.nfg");
+  GAMBIT_CHECK(!game->IsFrozen());
+  GAMBIT_CHECK(game->Freeze() == game);
+  GAMBIT_CHECK(game->IsFrozen());
+
+  GameOutcome outcome = game->GetOutcome(1);
+  GamePlayer player = game->GetPlayer(1);
+  CheckRefused(game, [&]() { outcome->SetPayoff(1, Number("17")); });
+  CheckRefused(game, [&]() { outcome->SetPayoff(player, Number("17")); });
+  CheckRefused(game, [&]() { game->NewOutcome(); });
+  CheckRefused(game, [&]() { game->DeleteOutcome(outcome); });
+  CheckRefused(game, [&]() { game->NewPlayer(); });
+  CheckRefused(game, [&]() { player->NewStrategy(); });
+  CheckRefused(game, [&]() { player->GetStrategy(1)->DeleteStrategy(); });
+  CheckRefused(game, [&]() {
+    game->NewPureStrategyProfile()->SetOutcome(game->GetOutcome(2));
+  });
+
+  // Changes which do not affect the payoffs or the structure are allowed
+  game->SetTitle("A frozen game");
+  GAMBIT_CHECK(game->GetTitle() == "A frozen game");
+}
+
+void TestFreezeTree()
+{
+  Game game = Test::ReadGameFile("cent2.efg");
+  game->Freeze();
+
+  GameNode root = game->GetRoot();
+  GameNode node = root->GetChild(1);
+  GameNode terminal = node;
+  while (terminal->NumChildren() > 0) {
+    terminal = terminal->GetChild(terminal->NumChildren());
+  }
+  GameInfoset infoset = node->GetInfoset();
+  GamePlayer player = game->GetPlayer(1);
+  GameOutcome outcome = game->GetOutcome(1);
+
+  CheckRefused(game, [&]() { outcome->SetPayoff(1, Number("17")); });
+  CheckRefused(game, [&]() { game->NewOutcome(); });
+  CheckRefused(game, [&]() { game->DeleteOutcome(outcome); });
+  CheckRefused(game, [&]() { game->NewPlayer(); });
+  CheckRefused(game, [&]() { terminal->SetOutcome(nullptr); });
+  CheckRefused(game, [&]() { terminal->SetOutcome(game->GetOutcome(2)); });
+  CheckRefused(game, [&]() { terminal->AppendMove(player, 2); });
+  CheckRefused(game, [&]() { terminal->AppendMove(infoset); });
+  CheckRefused(game, [&]() { node->InsertMove(player, 2); });
+  CheckRefused(game, [&]() { node->InsertMove(infoset); });
+  CheckRefused(game, [&]() { node->DeleteTree(); });
+  CheckRefused(game, [&]() { node->GetChild(1)->DeleteParent(); });
+  CheckRefused(game, [&]() { terminal->CopyTree(node); });
+  CheckRefused(game, [&]() { terminal->MoveTree(node); });
+  CheckRefused(game, [&]() { node->SetInfoset(infoset); });
+  CheckRefused(game, [&]() { node->LeaveInfoset(); });
+  CheckRefused(game, [&]() { infoset->SetPlayer(game->GetPlayer(2)); });
+  CheckRefused(game, [&]() { infoset->InsertAction(); });
+  CheckRefused(game, [&]() { infoset->GetAction(1)->DeleteAction(); });
+  CheckRefused(game, [&]() { infoset->Reveal(player); });
+
+  GameInfoset chance = game->GetChance()->GetInfoset(1);
+  Array<Number> probs(chance->NumActions());
+  for (int act = 1; act <= probs.Length(); act++) {
+    probs[act] = Rational(1, probs.Length());
+  }
+  CheckRefused(game, [&]() { game->SetChanceProbs(chance, probs); });
+}
+
+// A game which is not frozen still accepts the same changes
+void TestUnfrozenChanges()
+{
+  Game game = Test::ReadGameFile("cent2.efg");
+  int nodes = game->NumNodes();
+  game->GetRoot()->GetChild(1)->DeleteTree();
+  GAMBIT_CHECK(game->NumNodes() < nodes);
+
+  game = Test::ReadGameFile("2x2x2.nfg");
+  game->GetOutcome(1)->SetPayoff(1, Number("17"));
+  GAMBIT_CHECK(static_cast<Rational>(game->GetOutcome(1)->GetPayoff(1)) == Rational(17));
+}
+
+void TestFreezeAgg()
+{
+  Game game = Test::ReadGameFile("2x2.agg");
+  game->Freeze();
+  GamePlayer player = game->GetPlayer(1);
+  int strategies = player->NumStrategies();
+  GAMBIT_CHECK_THROWS(player->GetStrategy(1)->DeleteStrategy(), FrozenGameException);
+  GAMBIT_CHECK_THROWS(player->NewStrategy(), FrozenGameException);
+  GAMBIT_CHECK(player->NumStrategies() == strategies);
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  GAMBIT_TEST(TestFreezeTable);
+  GAMBIT_TEST(TestFreezeTree);
+  GAMBIT_TEST(TestUnfrozenChanges);
+  GAMBIT_TEST(TestFreezeAgg);
+  return Test::Report();
+}
@@ -0,0 +1,240 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2023, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: tests/test_rational.cc
+// Tests of rational arithmetic, inline and with Integers
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include <vector>
+#include "test.h"
+
+using namespace Gambit;
+
+namespace {
+
+bool IsInline(const Rational &x)
+{
+  long n, d;
+  return x.as_long_ratio(n, d);
+}
+
+// Checks that x is n/d in lowest terms with a positive denominator, and
+// that it is held inline exactly when both terms fit in a long
+void CheckValue(const Rational &x, const Integer &n, const Integer &d)
+{
+  GAMBIT_CHECK(x.numerator() == n);
+  GAMBIT_CHECK(x.denominator() == d);
+  GAMBIT_CHECK(d > Integer(0));
+  GAMBIT_CHECK(gcd(n, d) == Integer(1));
+  bool fits = n.fits_in_long() && d.fits_in_long() && n != Integer(LONG_MIN);
+  GAMBIT_CHECK(IsInline(x) == fits);
+}
+
+// A value computed with Integers, which serves as the reference
+Rational Reference(const Integer &n, const Integer &d)
+{
+  return Rational(n, d);
+}
+
+void TestOverflowPromotion()
+{
+  Rational max(LONG_MAX), one(1);
+  GAMBIT_CHECK(IsInline(max));
+
+  Rational sum = max + one;
+  CheckValue(sum, Integer(LONG_MAX) + Integer(1), Integer(1));
+  GAMBIT_CHECK(sum > max);
+  // Coming back into range demotes the value to the inline form
+  Rational back = sum - one;
+  CheckValue(back, Integer(LONG_MAX), Integer(1));
+  GAMBIT_CHECK(back == max);
+
+  // LONG_MIN fits in a long, but its negation does not; it is never
+  // held inline
+  Rational min = -max - one;
+  CheckValue(min, Integer(LONG_MIN), Integer(1));
+  GAMBIT_CHECK(min == Rational(LONG_MIN));
+  GAMBIT_CHECK(-min == sum);
+  GAMBIT_CHECK(!IsInline(Rational(LONG_MIN, 1L)));
+  GAMBIT_CHECK(Rational(LONG_MIN, 2L) == Rational(-(LONG_MAX / 2) - 1));
+  GAMBIT_CHECK(IsInline(Rational(LONG_MIN, 2L)));
+
+  Rational p40(1L << 40);
+  Rational p80 = p40 * p40;
+  CheckValue(p80, Integer(1L << 40) * Integer(1L << 40), Integer(1));
+  CheckValue(p80 / p40, Integer(1L << 40), Integer(1));
+
+  // Overflow in the denominator alone
+  Rational tiny = Rational(1L, LONG_MAX) * Rational(1L, 3L);
+  CheckValue(tiny, Integer(1), Integer(LONG_MAX) * Integer(3));
+  CheckValue(tiny * Rational(3L), Integer(1), Integer(LONG_MAX));
+  GAMBIT_CHECK(tiny < Rational(1L, LONG_MAX));
+  GAMBIT_CHECK(tiny > Rational(0));
+  GAMBIT_CHECK(Rational(1L, LONG_MAX) - tiny == Rational(2L, 3L) / Rational(LONG_MAX));
+
+  // Sums whose cross products overflow but whose result fits
+  Rational a(LONG_MAX - 1, LONG_MAX), b(1L, LONG_MAX);
+  CheckValue(a + b, Integer(1), Integer(1));
+  CheckValue(a - b, Integer(LONG_MAX - 2), Integer(LONG_MAX));
+}
+
+// Each operation on pairs of terms around the boundaries agrees with the
+// same operation done with Integers
+void TestAgainstIntegers()
+{
+  std::vector<long> terms = { 1, 2, 3, 7, 1L << 31, (1L << 32) + 1,
+                              (1L << 62) - 1, 1L << 62, LONG_MAX - 1, LONG_MAX };
+  std::vector<long> nums = { 0 };
+  for (long t : terms) {
+    nums.push_back(t);
+    nums.push_back(-t);
+  }
+  for (long xn : nums) {
+    for (long xd : terms) {
+      for (long yn : nums) {
+        for (long yd : terms) {
+          Rational x(xn, xd), y(yn, yd);
+          Integer Xn(xn), Xd(xd), Yn(yn), Yd(yd);
+          Rational sum = x + y, diff = x - y, prod = x * y;
+          GAMBIT_CHECK(sum == Reference(Xn * Yd + Yn * Xd, Xd * Yd));
+          GAMBIT_CHECK(diff == Reference(Xn * Yd - Yn * Xd, Xd * Yd));
+          GAMBIT_CHECK(prod == Reference(Xn * Yn, Xd * Yd));
+          CheckValue(sum, sum.numerator(), sum.denominator());
+          CheckValue(prod, prod.numerator(), prod.denominator());
+          if (yn != 0) {
+            Rational quot = x / y;
+            GAMBIT_CHECK(quot == Reference(Xn * Yd, Xd * Yn));
+            CheckValue(quot, quot.numerator(), quot.denominator());
+          }
+          GAMBIT_CHECK((compare(x, y) > 0) - (compare(x, y) < 0) == sign(diff));
+          GAMBIT_CHECK((x < y) == (sign(diff) < 0));
+          GAMBIT_CHECK((x == y) == (sign(diff) == 0));
+        }
+      }
+    }
+  }
+}
+
+void TestSigns()
+{
+  CheckValue(Rational(3, -6), Integer(-1), Integer(2));
+  CheckValue(Rational(-3, -6), Integer(1), Integer(2));
+  CheckValue(Rational(Integer(-4), Integer(-6)), Integer(2), Integer(3));
+  CheckValue(Rational(1L, LONG_MIN), Integer(-1), -Integer(LONG_MIN));
+  CheckValue(Rational(-1L, LONG_MIN), Integer(1), -Integer(LONG_MIN));
+
+  Rational x(-2, 3);
+  GAMBIT_CHECK(sign(x) == -1 && sign(-x) == 1 && sign(Rational(0)) == 0);
+  GAMBIT_CHECK(abs(x) == Rational(2, 3));
+  GAMBIT_CHECK(x / Rational(-4, 5) == Rational(5, 6));
+  x.invert();
+  CheckValue(x, Integer(-3), Integer(2));
+  x.negate();
+  CheckValue(x, Integer(3), Integer(2));
+  GAMBIT_CHECK(Rational(-1, 2) < Rational(1, 3));
+  GAMBIT_CHECK(Rational(-1, 2) < Rational(-1, 3));
+  GAMBIT_CHECK(-(Rational(LONG_MAX) + Rational(1)) < Rational(LONG_MIN + 1, 1L));
+
+  GAMBIT_CHECK(floor(Rational(-7, 2)) == Integer(-4));
+  GAMBIT_CHECK(ceil(Rational(-7, 2)) == Integer(-3));
+  GAMBIT_CHECK(floor(Rational(7, 2)) == Integer(3));
+  GAMBIT_CHECK(ceil(Rational(7, 2)) == Integer(4));
+  GAMBIT_CHECK(static_cast<double>(Rational(-3, 4)) == -0.75);
+
+  GAMBIT_CHECK_THROWS(Rational(1, 0), ZeroDivideException);
+  GAMBIT_CHECK_THROWS(Rational(1) / Rational(0), ZeroDivideException);
+  GAMBIT_CHECK_THROWS(Rational(0).invert(), ZeroDivideException);
+}
+
+void TestNormalization()
+{
+  CheckValue(Rational(6, 4), Integer(3), Integer(2));
+  CheckValue(Rational(0, -5), Integer(0), Integer(1));
+  CheckValue(Rational(1, 6) + Rational(1, 3), Integer(1), Integer(2));
+  CheckValue(Rational(2, 3) * Rational(9, 4), Integer(3), Integer(2));
+  CheckValue(Rational(1, 6) - Rational(1, 6), Integer(0), Integer(1));
+  CheckValue(Rational(Integer(10), Integer(4)), Integer(5), Integer(2));
+
+  // A large intermediate which cancels back down to a small value
+  Rational big = Reference(Integer(1L << 62) * Integer(1L << 8), Integer(3));
+  GAMBIT_CHECK(!IsInline(big));
+  CheckValue(big * Rational(3L, 1L << 40), Integer(1L << 30), Integer(1));
+  CheckValue(big / big, Integer(1), Integer(1));
+  CheckValue(big - big, Integer(0), Integer(1));
+
+  Rational acc(0);
+  for (int i = 1; i <= 20; i++) {
+    acc += Rational(1, i * (i + 1));
+  }
+  CheckValue(acc, Integer(20), Integer(21));
+}
+
+void TestParse()
+{
+  CheckValue(lexical_cast<Rational>(std::string("9223372036854775807")),
+             Integer(LONG_MAX), Integer(1));
+  CheckValue(lexical_cast<Rational>(std::string("9223372036854775808")),
+             Integer(LONG_MAX) + Integer(1), Integer(1));
+  CheckValue(lexical_cast<Rational>(std::string("-9223372036854775808")),
+             Integer(LONG_MIN), Integer(1));
+  CheckValue(lexical_cast<Rational>(std::string("-6/4")), Integer(-3), Integer(2));
+  CheckValue(lexical_cast<Rational>(std::string("0.25")), Integer(1), Integer(4));
+  CheckValue(lexical_cast<Rational>(std::string("-1.5")), Integer(-3), Integer(2));
+  CheckValue(lexical_cast<Rational>(std::string("1/18446744073709551616")),
+             Integer(1), Integer(1L << 32) * Integer(1L << 32));
+}
+
+// Reading from a stream, as solvers read starting profiles, stops at the
+// first character which is not part of the value
+void TestStream()
+{
+  std::istringstream s("1/2 3 -0.25,-6/4 9223372036854775808 1/18446744073709551616");
+  Rational x;
+  s >> x;
+  CheckValue(x, Integer(1), Integer(2));
+  s >> x;
+  CheckValue(x, Integer(3), Integer(1));
+  s >> x;
+  CheckValue(x, Integer(-1), Integer(4));
+  GAMBIT_CHECK(s.get() == ',');
+  s >> x;
+  CheckValue(x, Integer(-3), Integer(2));
+  s >> x;
+  CheckValue(x, Integer(LONG_MAX) + Integer(1), Integer(1));
+  s >> x;
+  CheckValue(x, Integer(1), Integer(1L << 32) * Integer(1L << 32));
+
+  std::istringstream bad("x");
+  GAMBIT_CHECK_THROWS(bad >> x, ValueException);
+  std::istringstream zero("1/0");
+  GAMBIT_CHECK_THROWS(zero >> x, ZeroDivideException);
+}
+
+}  // end anonymous namespace
+
+int main()
+{
+  GAMBIT_TEST(TestOverflowPromotion);
+  GAMBIT_TEST(TestAgainstIntegers);
+  GAMBIT_TEST(TestSigns);
+  GAMBIT_TEST(TestNormalization);
+  GAMBIT_TEST(TestParse);
+  GAMBIT_TEST(TestStream);
+  return Test::Report();
+}